@@ -0,0 +1,82 @@
+#pragma once
+
+#include "EngineFramework/ECS/ECS.h"
+#include <cstdint>
+
+namespace AlphaBench
+{
+	using namespace AlphaEngine;
+
+	// The component and system types the benchmarks are built from
+
+	// 8 different component types, big enough that the pools aren't free to move around
+	template <int N>
+	struct BenchComponent
+	{
+		float data[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	// Every system requires 1 to 3 of the components above
+	template <int ...Ns>
+	class BenchSystem : public System
+	{
+	public:
+		BenchSystem() { (RequireComponent<BenchComponent<Ns>>(), ...); }
+	};
+
+	inline void AddBenchSystems(ECSOrchestrator& ecs)
+	{
+		ecs.AddSystem<BenchSystem<0>>();
+		ecs.AddSystem<BenchSystem<1>>();
+		ecs.AddSystem<BenchSystem<2>>();
+		ecs.AddSystem<BenchSystem<3>>();
+		ecs.AddSystem<BenchSystem<4>>();
+		ecs.AddSystem<BenchSystem<5>>();
+		ecs.AddSystem<BenchSystem<6>>();
+		ecs.AddSystem<BenchSystem<7>>();
+		ecs.AddSystem<BenchSystem<0, 1>>();
+		ecs.AddSystem<BenchSystem<1, 2>>();
+		ecs.AddSystem<BenchSystem<2, 3>>();
+		ecs.AddSystem<BenchSystem<3, 4>>();
+		ecs.AddSystem<BenchSystem<4, 5>>();
+		ecs.AddSystem<BenchSystem<5, 6>>();
+		ecs.AddSystem<BenchSystem<6, 7>>();
+		ecs.AddSystem<BenchSystem<0, 7>>();
+		ecs.AddSystem<BenchSystem<0, 1, 2>>();
+		ecs.AddSystem<BenchSystem<1, 3, 5>>();
+		ecs.AddSystem<BenchSystem<2, 4, 6>>();
+		ecs.AddSystem<BenchSystem<3, 5, 7>>();
+		ecs.AddSystem<BenchSystem<0, 4, 7>>();
+		ecs.AddSystem<BenchSystem<1, 6, 7>>();
+		ecs.AddSystem<BenchSystem<0, 2, 5>>();
+		ecs.AddSystem<BenchSystem<3, 4, 6>>();
+	}
+
+	inline void AddBenchComponent(ECSOrchestrator& ecs, Entity entity, uint32_t which)
+	{
+		switch (which) {
+		case 0: ecs.AddComponent<BenchComponent<0>>(entity); break;
+		case 1: ecs.AddComponent<BenchComponent<1>>(entity); break;
+		case 2: ecs.AddComponent<BenchComponent<2>>(entity); break;
+		case 3: ecs.AddComponent<BenchComponent<3>>(entity); break;
+		case 4: ecs.AddComponent<BenchComponent<4>>(entity); break;
+		case 5: ecs.AddComponent<BenchComponent<5>>(entity); break;
+		case 6: ecs.AddComponent<BenchComponent<6>>(entity); break;
+		default: ecs.AddComponent<BenchComponent<7>>(entity); break;
+		}
+	}
+
+	inline void RemoveBenchComponent(ECSOrchestrator& ecs, Entity entity, uint32_t which)
+	{
+		switch (which) {
+		case 0: ecs.RemoveComponent<BenchComponent<0>>(entity); break;
+		case 1: ecs.RemoveComponent<BenchComponent<1>>(entity); break;
+		case 2: ecs.RemoveComponent<BenchComponent<2>>(entity); break;
+		case 3: ecs.RemoveComponent<BenchComponent<3>>(entity); break;
+		case 4: ecs.RemoveComponent<BenchComponent<4>>(entity); break;
+		case 5: ecs.RemoveComponent<BenchComponent<5>>(entity); break;
+		case 6: ecs.RemoveComponent<BenchComponent<6>>(entity); break;
+		default: ecs.RemoveComponent<BenchComponent<7>>(entity); break;
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#include "BenchReport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace AlphaBench
+{
+	static volatile uint64_t s_Sink = 0;
+
+	void Consume(uint64_t value)
+	{
+		s_Sink = s_Sink + value;
+	}
+
+	BenchStats ComputeStats(std::vector<double> sampleNs, uint64_t operations)
+	{
+		BenchStats stats;
+		if (sampleNs.empty() || operations == 0) return stats;
+
+		for (double& sample : sampleNs) sample /= static_cast<double>(operations);
+		std::sort(sampleNs.begin(), sampleNs.end());
+
+		const size_t count = sampleNs.size();
+		stats.min = sampleNs.front();
+		stats.median = count % 2 ? sampleNs[count / 2] : (sampleNs[count / 2 - 1] + sampleNs[count / 2]) * 0.5;
+		stats.p90 = sampleNs[std::min(count - 1, static_cast<size_t>(std::ceil(count * 0.9)) - 1)];
+
+		double sum = 0.0;
+		for (double sample : sampleNs) sum += sample;
+		stats.mean = sum / count;
+
+		double variance = 0.0;
+		for (double sample : sampleNs) variance += (sample - stats.mean) * (sample - stats.mean);
+		stats.stddev = std::sqrt(variance / count);
+
+		return stats;
+	}
+
+	bool BenchReport::ShouldRun(const std::string& name) const
+	{
+		return m_Filter.empty() || name.find(m_Filter) != std::string::npos;
+	}
+
+	void BenchReport::Add(BenchResult result)
+	{
+		m_Results.push_back(std::move(result));
+	}
+
+	void BenchReport::PrintTable(std::ostream& out) const
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-28s %-11s %8s %12s %12s %12s %10s\n", "case", "backend", "entities", "median ns/op", "min ns/op", "p90 ns/op", "GB/s");
+		out << line;
+
+		for (const BenchResult& result : m_Results) {
+			const double gbPerSecond = result.nsPerOp.median > 0.0 ? result.bytesPerOp / result.nsPerOp.median : 0.0;
+			std::snprintf(line, sizeof(line), "%-28s %-11s %8u %12.2f %12.2f %12.2f %10.2f\n", result.name.c_str(), result.backend.c_str(),
+				result.entities, result.nsPerOp.median, result.nsPerOp.min, result.nsPerOp.p90, gbPerSecond);
+			out << line;
+		}
+	}
+
+	// Our names never need escaping, but a filter typed on the command line could end up in there one day
+	static std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\') escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	void BenchReport::WriteJson(std::ostream& out, uint32_t samplesPerCase) const
+	{
+		char number[64];
+		auto write = [&](double value) {
+			std::snprintf(number, sizeof(number), "%.3f", value);
+			out << number;
+		};
+
+		out << "{\n";
+		out << "  \"suite\": \"AlphaEngineBench\",\n";
+#ifdef NDEBUG
+		out << "  \"build\": \"release\",\n";
+#else
+		out << "  \"build\": \"debug\",\n";
+#endif
+		out << "  \"samples_per_case\": " << samplesPerCase << ",\n";
+		out << "  \"results\": [\n";
+
+		for (size_t i = 0; i < m_Results.size(); ++i) {
+			const BenchResult& result = m_Results[i];
+			const double gbPerSecond = result.nsPerOp.median > 0.0 ? result.bytesPerOp / result.nsPerOp.median : 0.0;
+
+			out << "    {\"name\": \"" << EscapeJson(result.name) << "\", \"backend\": \"" << EscapeJson(result.backend) << "\"";
+			out << ", \"entities\": " << result.entities << ", \"operations\": " << result.operations << ", \"samples\": " << result.samples;
+			out << ", \"ns_per_op\": {\"median\": "; write(result.nsPerOp.median);
+			out << ", \"min\": "; write(result.nsPerOp.min);
+			out << ", \"p90\": "; write(result.nsPerOp.p90);
+			out << ", \"mean\": "; write(result.nsPerOp.mean);
+			out << ", \"stddev\": "; write(result.nsPerOp.stddev);
+			out << "}, \"bytes_per_op\": "; write(result.bytesPerOp);
+			out << ", \"working_set_bytes\": " << result.workingSetBytes;
+			out << ", \"gb_per_s\": "; write(gbPerSecond);
+			out << "}" << (i + 1 < m_Results.size() ? "," : "") << "\n";
+		}
+
+		out << "  ]\n";
+		out << "}\n";
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <ostream>
+
+namespace AlphaBench
+{
+	// Time per operation over all the samples of a case.
+	// The median is what to compare between runs, min is the best the machine can do,
+	// and a p90 far above the median means the case is noisy (or hitting something periodic like a reallocation)
+	struct BenchStats
+	{
+		double median = 0.0;
+		double min = 0.0;
+		double p90 = 0.0;
+		double mean = 0.0;
+		double stddev = 0.0;
+	};
+
+	struct BenchResult
+	{
+		// "group.case", e.g. "pool.get_random"
+		std::string name;
+		// "sparse_set", "archetype", "group" or "" when the storage doesn't matter
+		std::string backend;
+		uint32_t entities = 0;
+		// Operations timed per sample, the stats are per operation
+		uint64_t operations = 0;
+		uint32_t samples = 0;
+		BenchStats nsPerOp;
+
+		// The memory side, so a regression can be told apart from a layout change:
+		// bytesPerOp -> component bytes an operation reads or writes
+		// workingSetBytes -> everything the case walks over, compare it with the cache sizes of the machine
+		// (a case that jumps from L2 to DRAM between 10k and 100k is a cache effect, not a code one)
+		double bytesPerOp = 0.0;
+		uint64_t workingSetBytes = 0;
+	};
+
+	// Every sample is one timed run of 'operations' operations, turns them into per operation statistics
+	BenchStats ComputeStats(std::vector<double> sampleNs, uint64_t operations);
+
+	// Keeps the optimizer from dropping loops whose result nobody reads
+	void Consume(uint64_t value);
+
+	template <typename F>
+	double TimeNs(F&& work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		work();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	class BenchReport
+	{
+	private:
+		std::vector<BenchResult> m_Results;
+		std::string m_Filter;
+
+	public:
+		explicit BenchReport(std::string filter = "") : m_Filter(std::move(filter)) {}
+
+		// False if --filter excludes the case, check it before doing the (sometimes long) setup
+		bool ShouldRun(const std::string& name) const;
+
+		void Add(BenchResult result);
+
+		// One line per case, for humans
+		void PrintTable(std::ostream& out) const;
+
+		// The machine readable report (see Main.cpp for the layout)
+		void WriteJson(std::ostream& out, uint32_t samplesPerCase) const;
+
+		const std::vector<BenchResult>& GetResults() const { return m_Results; }
+	};
+}
@@ -0,0 +1,90 @@
+#include "ChurnBench.h"
+#include "BenchComponents.h"
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+namespace AlphaBench
+{
+	using namespace AlphaEngine;
+
+	// 2 to 4 random components, like a mix of props, enemies and projectiles
+	static Entity SpawnRandomEntity(ECSOrchestrator& ecs, std::mt19937& random)
+	{
+		Entity entity = ecs.CreateEntity();
+		const uint32_t componentCount = 2 + random() % 3;
+		for (uint32_t i = 0; i < componentCount; ++i) {
+			AddBenchComponent(ecs, entity, random() % 8);
+		}
+		return entity;
+	}
+
+	ChurnBenchResult RunChurnBench(const ChurnBenchSettings& settings)
+	{
+		// Declared first, it has to outlive the orchestrator
+		ChurnPoolResource churnPool;
+		ECSMemoryConfig memoryConfig;
+		if (settings.useChurnPoolResource) {
+			memoryConfig.bookkeeping = &churnPool;
+			memoryConfig.components = &churnPool;
+		}
+
+		ECSOrchestrator ecs(ECSStorageBackend::SparseSet, memoryConfig);
+		AddBenchSystems(ecs);
+
+		// Fixed seed, every run does exactly the same work
+		std::mt19937 random(1234);
+
+		std::vector<Entity> persistent;
+		persistent.reserve(settings.persistentEntities);
+		for (uint32_t i = 0; i < settings.persistentEntities; ++i) {
+			persistent.push_back(SpawnRandomEntity(ecs, random));
+		}
+		ecs.UpdateEntitiesLifeTime();
+
+		std::vector<Entity> spawnedLastFrame;
+		std::vector<Entity> spawnedThisFrame;
+		spawnedLastFrame.reserve(settings.churnPerFrame);
+		spawnedThisFrame.reserve(settings.churnPerFrame);
+
+		ChurnBenchResult result;
+		result.systemCount = 24;
+		result.frameMs.reserve(settings.frames);
+		result.minFrameMs = 1e30;
+		double totalMs = 0.0;
+
+		for (uint32_t frame = 0; frame < settings.warmupFrames + settings.frames; ++frame) {
+			const auto start = std::chrono::steady_clock::now();
+
+			for (const Entity& entity : spawnedLastFrame) {
+				ecs.DestroyEntity(entity);
+			}
+
+			spawnedThisFrame.clear();
+			for (uint32_t i = 0; i < settings.churnPerFrame; ++i) {
+				spawnedThisFrame.push_back(SpawnRandomEntity(ecs, random));
+			}
+
+			for (uint32_t i = 0; i < settings.mutationsPerFrame; ++i) {
+				const Entity entity = persistent[random() % persistent.size()];
+				const uint32_t which = random() % 8;
+				if (random() % 2) AddBenchComponent(ecs, entity, which);
+				else RemoveBenchComponent(ecs, entity, which);
+			}
+
+			ecs.UpdateEntitiesLifeTime();
+
+			const double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			std::swap(spawnedLastFrame, spawnedThisFrame);
+
+			if (frame < settings.warmupFrames) continue;
+			result.frameMs.push_back(frameMs);
+			totalMs += frameMs;
+			result.minFrameMs = std::min(result.minFrameMs, frameMs);
+			result.maxFrameMs = std::max(result.maxFrameMs, frameMs);
+		}
+
+		result.averageFrameMs = totalMs / settings.frames;
+		return result;
+	}
+}
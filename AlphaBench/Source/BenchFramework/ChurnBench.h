@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace AlphaBench
+{
+	struct ChurnBenchSettings
+	{
+		// Entities that live for the whole run, the systems are never empty
+		uint32_t persistentEntities = 50000;
+		// Spawned every frame and destroyed the frame after
+		uint32_t churnPerFrame = 10000;
+		// Live entities that gain or lose a component every frame (the RefreshEntity path)
+		uint32_t mutationsPerFrame = 1000;
+		uint32_t warmupFrames = 10;
+		uint32_t frames = 100;
+		// Pools and bookkeeping allocate from a ChurnPoolResource instead of the heap
+		bool useChurnPoolResource = false;
+	};
+
+	struct ChurnBenchResult
+	{
+		uint32_t systemCount = 0;
+		double averageFrameMs = 0.0;
+		double minFrameMs = 0.0;
+		double maxFrameMs = 0.0;
+		// Every measured frame, for the statistics of the JSON report
+		std::vector<double> frameMs;
+	};
+
+	// Spawning and destroying entities with a random mix of components against 24 registered systems.
+	// Measures the whole frame: creating, adding components, destroying and UpdateEntitiesLifeTime
+	ChurnBenchResult RunChurnBench(const ChurnBenchSettings& settings);
+}
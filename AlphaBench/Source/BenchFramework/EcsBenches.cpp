@@ -0,0 +1,684 @@
+#include "EcsBenches.h"
+#include "BenchComponents.h"
+#include "ChurnBench.h"
+#include "EngineFramework/ECS/WorldSnapshot.h"
+#include "EngineFramework/ECS/SignatureMatch.h"
+#include "EngineFramework/Systems/TransformSystem.h"
+#include "EngineFramework/Systems/SpatialGridSystem.h"
+#include "EngineFramework/TransformStreams.h"
+#include "EngineFramework/Renderer/RenderSortKey.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+
+namespace AlphaBench
+{
+	// Not trivially copyable, so the snapshot has to go through its serializer
+	struct BenchName
+	{
+		std::string name;
+	};
+
+	static std::vector<uint32_t> ShuffledIndices(uint32_t count, uint32_t seed)
+	{
+		std::vector<uint32_t> indices(count);
+		std::iota(indices.begin(), indices.end(), 0u);
+		std::shuffle(indices.begin(), indices.end(), std::mt19937(seed));
+		return indices;
+	}
+
+	// 'setup' is untimed and runs before every 'work'. The first run is a warmup and is thrown away
+	template <typename Setup, typename Work>
+	static std::vector<double> Sample(uint32_t samples, Setup&& setup, Work&& work)
+	{
+		std::vector<double> sampleNs;
+		sampleNs.reserve(samples);
+		for (uint32_t i = 0; i <= samples; ++i) {
+			setup();
+			const double ns = TimeNs(work);
+			if (i > 0) sampleNs.push_back(ns);
+		}
+		return sampleNs;
+	}
+
+	static void Record(BenchReport& report, const std::string& name, const std::string& backend, uint32_t entities, uint64_t operations,
+		const std::vector<double>& sampleNs, double bytesPerOp, uint64_t workingSetBytes)
+	{
+		BenchResult result;
+		result.name = name;
+		result.backend = backend;
+		result.entities = entities;
+		result.operations = operations;
+		result.samples = static_cast<uint32_t>(sampleNs.size());
+		result.nsPerOp = ComputeStats(sampleNs, operations);
+		result.bytesPerOp = bytesPerOp;
+		result.workingSetBytes = workingSetBytes;
+		report.Add(std::move(result));
+	}
+
+	// <-------------------------- Pools ----------------------------->
+
+	void RunPoolBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		using Data = BenchComponent<0>;
+
+		for (const uint32_t count : settings.entityCounts) {
+			const std::vector<uint32_t> randomOrder = ShuffledIndices(count, 1234);
+			// Data + entity + both ticks per component (the sparse pages come on top)
+			const uint64_t workingSet = static_cast<uint64_t>(count) * (sizeof(Data) + sizeof(Entity) + 2 * sizeof(uint32_t));
+
+			std::unique_ptr<ComponentPool<Data>> pool;
+			auto fillPool = [&]() {
+				pool = std::make_unique<ComponentPool<Data>>();
+				for (uint32_t i = 0; i < count; ++i) {
+					pool->AddComp(Entity(i, 0), Data{}, 1);
+				}
+			};
+
+			if (report.ShouldRun("pool.add")) {
+				const auto samples = Sample(settings.samples,
+					[&]() { pool = std::make_unique<ComponentPool<Data>>(); },
+					[&]() {
+						for (uint32_t i = 0; i < count; ++i) {
+							pool->AddComp(Entity(i, 0), Data{}, 1);
+						}
+					});
+				Record(report, "pool.add", "sparse_set", count, count, samples, sizeof(Data), workingSet);
+			}
+
+			if (report.ShouldRun("pool.get_sequential") || report.ShouldRun("pool.get_random")) {
+				fillPool();
+				auto getInOrder = [&](const std::vector<uint32_t>* order) {
+					float sum = 0.0f;
+					for (uint32_t i = 0; i < count; ++i) {
+						sum += pool->Get(order ? (*order)[i] : i).data[0];
+					}
+					Consume(static_cast<uint64_t>(sum));
+				};
+
+				if (report.ShouldRun("pool.get_sequential")) {
+					const auto samples = Sample(settings.samples, []() {}, [&]() { getInOrder(nullptr); });
+					Record(report, "pool.get_sequential", "sparse_set", count, count, samples, sizeof(Data), workingSet);
+				}
+				// Same lookups, but every one lands on a different cache line (once the pool is bigger than the caches)
+				if (report.ShouldRun("pool.get_random")) {
+					const auto samples = Sample(settings.samples, []() {}, [&]() { getInOrder(&randomOrder); });
+					Record(report, "pool.get_random", "sparse_set", count, count, samples, sizeof(Data), workingSet);
+				}
+			}
+
+			if (report.ShouldRun("pool.remove")) {
+				const auto samples = Sample(settings.samples, fillPool,
+					[&]() {
+						for (const uint32_t entityId : randomOrder) {
+							pool->RemoveComp(entityId);
+						}
+					});
+				Record(report, "pool.remove", "sparse_set", count, count, samples, sizeof(Data), workingSet);
+			}
+		}
+	}
+
+	// <-------------------------- Systems ----------------------------->
+
+	void RunSystemBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		for (const uint32_t count : settings.entityCounts) {
+			const std::vector<uint32_t> randomOrder = ShuffledIndices(count, 4321);
+			const uint64_t workingSet = static_cast<uint64_t>(count) * (sizeof(Entity) + sizeof(int32_t));
+
+			std::unique_ptr<System> system;
+			auto fillSystem = [&]() {
+				system = std::make_unique<System>();
+				for (uint32_t i = 0; i < count; ++i) {
+					system->AddEntityToSystem(Entity(i, 0));
+				}
+			};
+
+			if (report.ShouldRun("system.add_entity")) {
+				const auto samples = Sample(settings.samples,
+					[&]() { system = std::make_unique<System>(); },
+					[&]() {
+						for (uint32_t i = 0; i < count; ++i) {
+							system->AddEntityToSystem(Entity(i, 0));
+						}
+					});
+				Record(report, "system.add_entity", "", count, count, samples, sizeof(Entity), workingSet);
+			}
+
+			if (report.ShouldRun("system.remove_entity")) {
+				const auto samples = Sample(settings.samples, fillSystem,
+					[&]() {
+						for (const uint32_t entityId : randomOrder) {
+							system->RemoveEntityFromSystem(Entity(entityId, 0));
+						}
+					});
+				Record(report, "system.remove_entity", "", count, count, samples, sizeof(Entity), workingSet);
+			}
+		}
+	}
+
+	// <-------------------------- Entity lifetime ----------------------------->
+
+	void RunLifetimeBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		for (const uint32_t count : settings.entityCounts) {
+			ChurnBenchSettings churnSettings;
+			churnSettings.persistentEntities = count;
+			churnSettings.churnPerFrame = std::max(1u, count / 10);
+			churnSettings.mutationsPerFrame = std::max(1u, count / 100);
+			churnSettings.warmupFrames = 5;
+			churnSettings.frames = settings.samples;
+
+			const uint64_t operations = 2ull * churnSettings.churnPerFrame + churnSettings.mutationsPerFrame;
+
+			for (const bool useChurnPool : { false, true }) {
+				const std::string name = useChurnPool ? "lifetime.churn_pool_resource" : "lifetime.churn";
+				if (!report.ShouldRun(name)) continue;
+
+				churnSettings.useChurnPoolResource = useChurnPool;
+				const ChurnBenchResult churn = RunChurnBench(churnSettings);
+
+				std::vector<double> sampleNs;
+				sampleNs.reserve(churn.frameMs.size());
+				for (double frameMs : churn.frameMs) sampleNs.push_back(frameMs * 1e6);
+				Record(report, name, "sparse_set", count, operations, sampleNs, 0.0, 0);
+			}
+		}
+	}
+
+	// <-------------------------- Iteration ----------------------------->
+
+	// Adds T to every 'every'th entity, in a shuffled order
+	template <typename T>
+	static void AddShuffled(ECSOrchestrator& ecs, const std::vector<Entity>& entities, uint32_t seed, uint32_t every)
+	{
+		std::vector<Entity> targets;
+		targets.reserve(entities.size());
+		for (const uint32_t i : ShuffledIndices(static_cast<uint32_t>(entities.size()), seed)) {
+			if (i % every == 0) targets.push_back(entities[i]);
+		}
+		std::vector<T> values(targets.size());
+		ecs.AddComponents<T>(targets, std::span<T>(values));
+	}
+
+	// Everybody gets the 3 iterated components, each added in a different order so the sparse set pools
+	// are not accidentally aligned. Half also get a 4th one, which splits the archetypes in two
+	static void BuildIterationWorld(ECSOrchestrator& ecs, uint32_t count)
+	{
+		const std::vector<Entity> entities = ecs.CreateEntities(count);
+
+		AddShuffled<BenchComponent<0>>(ecs, entities, 0, 1);
+		AddShuffled<BenchComponent<1>>(ecs, entities, 11, 1);
+		AddShuffled<BenchComponent<2>>(ecs, entities, 22, 1);
+		AddShuffled<BenchComponent<3>>(ecs, entities, 33, 2);
+
+		ecs.UpdateEntitiesLifeTime();
+	}
+
+	template <typename ...Ts, typename MakeView>
+	static void MeasureIteration(BenchReport& report, const SuiteSettings& settings, const std::string& name, const std::string& backend,
+		uint32_t count, MakeView&& makeView)
+	{
+		if (!report.ShouldRun(name)) return;
+
+		const auto samples = Sample(settings.samples, []() {},
+			[&]() {
+				float sum = 0.0f;
+				for (auto&& row : makeView()) {
+					std::apply([&](Entity, auto&... components) { ((sum += components.data[0]), ...); }, row);
+				}
+				Consume(static_cast<uint64_t>(sum));
+			});
+
+		constexpr double bytesPerOp = static_cast<double>((sizeof(Ts) + ...));
+		Record(report, name, backend, count, count, samples, bytesPerOp, static_cast<uint64_t>(count) * ((sizeof(Ts) + ...) + sizeof(Entity)));
+	}
+
+	void RunIterationBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		using C0 = BenchComponent<0>;
+		using C1 = BenchComponent<1>;
+		using C2 = BenchComponent<2>;
+
+		for (const uint32_t count : settings.entityCounts) {
+			for (const ECSStorageBackend backend : { ECSStorageBackend::SparseSet, ECSStorageBackend::Archetype }) {
+				const std::string backendName = backend == ECSStorageBackend::Archetype ? "archetype" : "sparse_set";
+				if (!report.ShouldRun("iterate.view_1") && !report.ShouldRun("iterate.view_2") && !report.ShouldRun("iterate.view_3")) continue;
+
+				ECSOrchestrator ecs(backend);
+				BuildIterationWorld(ecs, count);
+
+				MeasureIteration<C0>(report, settings, "iterate.view_1", backendName, count, [&]() { return ecs.View<C0>(); });
+				MeasureIteration<C0, C1>(report, settings, "iterate.view_2", backendName, count, [&]() { return ecs.View<C0, C1>(); });
+				MeasureIteration<C0, C1, C2>(report, settings, "iterate.view_3", backendName, count, [&]() { return ecs.View<C0, C1, C2>(); });
+			}
+
+			// A pool can only belong to one group, so every group gets its own world
+			if (report.ShouldRun("iterate.group_2")) {
+				ECSOrchestrator ecs;
+				BuildIterationWorld(ecs, count);
+				ecs.Group<C0, C1>();
+				MeasureIteration<C0, C1>(report, settings, "iterate.group_2", "group", count, [&]() { return ecs.Group<C0, C1>(); });
+			}
+			if (report.ShouldRun("iterate.group_3")) {
+				ECSOrchestrator ecs;
+				BuildIterationWorld(ecs, count);
+				ecs.Group<C0, C1, C2>();
+				MeasureIteration<C0, C1, C2>(report, settings, "iterate.group_3", "group", count, [&]() { return ecs.Group<C0, C1, C2>(); });
+			}
+		}
+	}
+
+	// <-------------------------- Signatures ----------------------------->
+
+	// Every bit on with a 40% chance
+	static std::vector<Signature> RandomSignatures(uint32_t count, uint32_t maxBits, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::bernoulli_distribution on(0.4);
+		std::vector<Signature> signatures(count);
+		for (Signature& signature : signatures) {
+			for (uint32_t bit = 0; bit < maxBits; ++bit) {
+				if (on(random)) signature.set(bit);
+			}
+		}
+		return signatures;
+	}
+
+	// What the systems and queries look like: 1 to 3 required components
+	static std::vector<Signature> RandomRequirements(uint32_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<uint32_t> component(0, MAX_COMPONENTS - 1);
+		std::vector<Signature> requirements(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			for (uint32_t bit = 0; bit <= i % 3; ++bit) requirements[i].set(component(random));
+		}
+		return requirements;
+	}
+
+	// The same signatures as std::bitset, the way Signature was stored before it had a known layout
+	static std::vector<std::bitset<MAX_COMPONENTS>> ToBitsets(const std::vector<Signature>& signatures)
+	{
+		std::vector<std::bitset<MAX_COMPONENTS>> bitsets(signatures.size());
+		for (size_t i = 0; i < signatures.size(); ++i) {
+			ForEachComponent(signatures[i], [&](uint16_t componentId) { bitsets[i].set(componentId); });
+		}
+		return bitsets;
+	}
+
+	void RunSignatureBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		const std::string kernel = SignatureMatch::GetKernelName();
+		// Only the low components are common, like in a real world
+		const uint32_t usedBits = std::min<uint32_t>(MAX_COMPONENTS, 24);
+
+		// The kernel is called directly, the engine only uses it where it won (SignatureMatch::UseKernel).
+		// Every backend hands back the indices that matched, that's what the engine needs (archetypes to walk, systems to add to)
+		std::vector<uint32_t> matches;
+
+		for (const uint32_t count : settings.entityCounts) {
+			// One query against every entity signature (a view without pools to drive it, or the archetype list of a huge world)
+			if (report.ShouldRun("signature.match_entities")) {
+				const std::vector<Signature> signatures = RandomSignatures(count, usedBits, 99);
+				const std::vector<std::bitset<MAX_COMPONENTS>> bitsets = ToBitsets(signatures);
+				Signature required;
+				required.set(1).set(4);
+				std::bitset<MAX_COMPONENTS> requiredBits;
+				requiredBits.set(1).set(4);
+
+				matches.reserve(count);
+				const uint64_t workingSet = static_cast<uint64_t>(count) * sizeof(Signature);
+				auto reset = [&]() { matches.clear(); };
+
+				const auto bitsetSamples = Sample(settings.samples, reset, [&]() {
+					for (uint32_t i = 0; i < count; ++i) {
+						if ((bitsets[i] & requiredBits) == requiredBits) matches.push_back(i);
+					}
+					Consume(matches.size());
+					});
+				Record(report, "signature.match_entities", "bitset", count, count, bitsetSamples, sizeof(std::bitset<MAX_COMPONENTS>), count * sizeof(std::bitset<MAX_COMPONENTS>));
+
+				const auto scalarSamples = Sample(settings.samples, reset, [&]() {
+					for (uint32_t i = 0; i < count; ++i) {
+						if (signatures[i].Contains(required)) matches.push_back(i);
+					}
+					Consume(matches.size());
+					});
+				Record(report, "signature.match_entities", "scalar", count, count, scalarSamples, sizeof(Signature), workingSet);
+
+				const auto kernelSamples = Sample(settings.samples, reset, [&]() {
+					SignatureMatch::ForEachMatch<false>(signatures.data(), signatures.size(), required, [&](size_t i) { matches.push_back(static_cast<uint32_t>(i)); });
+					Consume(matches.size());
+					});
+				Record(report, "signature.match_entities", kernel, count, count, kernelSamples, sizeof(Signature), workingSet);
+			}
+
+			// Every entity against the requirements of 64 systems (what a world full of new entities does).
+			// ns/op is per entity/system pair
+			if (report.ShouldRun("signature.match_systems")) {
+				const std::vector<Signature> signatures = RandomSignatures(count, usedBits, 77);
+				const std::vector<std::bitset<MAX_COMPONENTS>> bitsets = ToBitsets(signatures);
+				const std::vector<Signature> requirements = RandomRequirements(64, 55);
+				const std::vector<std::bitset<MAX_COMPONENTS>> requirementBits = ToBitsets(requirements);
+				const uint32_t systemCount = static_cast<uint32_t>(requirements.size());
+
+				matches.reserve(systemCount);
+				const uint64_t operations = static_cast<uint64_t>(count) * systemCount;
+				const uint64_t workingSet = static_cast<uint64_t>(count + systemCount) * sizeof(Signature);
+
+				const auto bitsetSamples = Sample(settings.samples, []() {}, [&]() {
+					uint64_t total = 0;
+					for (const auto& bits : bitsets) {
+						matches.clear();
+						for (uint32_t i = 0; i < systemCount; ++i) {
+							if ((bits & requirementBits[i]) == requirementBits[i]) matches.push_back(i);
+						}
+						total += matches.size();
+					}
+					Consume(total);
+					});
+				Record(report, "signature.match_systems", "bitset", count, operations, bitsetSamples, sizeof(std::bitset<MAX_COMPONENTS>), workingSet);
+
+				const auto scalarSamples = Sample(settings.samples, []() {}, [&]() {
+					uint64_t total = 0;
+					for (const Signature& signature : signatures) {
+						matches.clear();
+						for (uint32_t i = 0; i < systemCount; ++i) {
+							if (signature.Contains(requirements[i])) matches.push_back(i);
+						}
+						total += matches.size();
+					}
+					Consume(total);
+					});
+				Record(report, "signature.match_systems", "scalar", count, operations, scalarSamples, sizeof(Signature), workingSet);
+
+				const auto kernelSamples = Sample(settings.samples, []() {}, [&]() {
+					uint64_t total = 0;
+					for (const Signature& signature : signatures) {
+						matches.clear();
+						SignatureMatch::ForEachMatch<true>(requirements.data(), systemCount, signature, [&](size_t i) { matches.push_back(static_cast<uint32_t>(i)); });
+						total += matches.size();
+					}
+					Consume(total);
+					});
+				Record(report, "signature.match_systems", kernel, count, operations, kernelSamples, sizeof(Signature), workingSet);
+			}
+		}
+	}
+
+	// <-------------------------- Transforms ----------------------------->
+
+	static TransformComponent RandomTransform(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		TransformComponent transform(glm::vec3(distribution(random), distribution(random), distribution(random)) * 100.0f);
+		transform.rotation = glm::normalize(glm::quat(distribution(random), distribution(random), distribution(random), distribution(random)));
+		transform.scale = glm::vec3(1.0f + distribution(random) * 0.5f);
+		return transform;
+	}
+
+	void RunTransformBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		const std::string kernel = GetTransformKernelName();
+
+		for (const uint32_t count : settings.entityCounts) {
+			// Just the math: TransformComponent::GetTransform one by one against ComposeTransforms over the same transforms
+			if (report.ShouldRun("transform.compose")) {
+				std::mt19937 random(2024);
+				std::vector<TransformComponent> transforms;
+				TransformStreams streams;
+				transforms.reserve(count);
+				streams.Reserve(count);
+				for (uint32_t i = 0; i < count; ++i) {
+					transforms.push_back(RandomTransform(random));
+					streams.Push(transforms.back().position, transforms.back().rotation, transforms.back().scale);
+				}
+				std::vector<glm::mat4> matrices(count);
+				const uint64_t workingSet = static_cast<uint64_t>(count) * (sizeof(TransformComponent) + sizeof(glm::mat4));
+
+				const auto aosSamples = Sample(settings.samples, []() {}, [&]() {
+					for (uint32_t i = 0; i < count; ++i) {
+						matrices[i] = transforms[i].GetTransform();
+					}
+					Consume(static_cast<uint64_t>(matrices[count - 1][3][0]));
+					});
+				Record(report, "transform.compose", "aos", count, count, aosSamples, sizeof(TransformComponent), workingSet);
+
+				const auto kernelSamples = Sample(settings.samples, []() {}, [&]() {
+					ComposeTransforms(streams, matrices.data());
+					Consume(static_cast<uint64_t>(matrices[count - 1][3][0]));
+					});
+				Record(report, "transform.compose", kernel, count, count, kernelSamples, sizeof(TransformComponent), workingSet);
+			}
+
+			// A whole TransformSystem run where every root moved (the physics step of a world full of balls),
+			// gathering, composing and writing the WorldTransformComponents included
+			if (report.ShouldRun("transform.system")) {
+				const uint64_t workingSet = static_cast<uint64_t>(count) * (sizeof(TransformComponent) + sizeof(WorldTransformComponent));
+
+				for (const TransformLayout layout : { TransformLayout::AoS, TransformLayout::SoA }) {
+					ECSOrchestrator ecs;
+					TransformSystem& transformSystem = ecs.AddSystem<TransformSystem>(ecs, layout);
+
+					std::mt19937 random(2024);
+					std::vector<Entity> entities = ecs.CreateEntities(count);
+					for (const Entity entity : entities) {
+						ecs.AddComponent<TransformComponent>(entity, RandomTransform(random));
+					}
+					ecs.UpdateEntitiesLifeTime();
+					transformSystem.RunSystem(ecs);
+
+					const auto samples = Sample(settings.samples,
+						[&]() {
+							for (const Entity entity : entities) {
+								ecs.PatchComponent<TransformComponent>(entity).position.x += 0.01f;
+							}
+						},
+						[&]() { transformSystem.RunSystem(ecs); });
+					Record(report, "transform.system", layout == TransformLayout::AoS ? "aos" : "soa", count, count, samples, sizeof(TransformComponent), workingSet);
+				}
+			}
+		}
+	}
+
+	// <-------------------------- Spatial queries ----------------------------->
+
+	void RunSpatialBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		if (!report.ShouldRun("spatial.query_sphere") && !report.ShouldRun("spatial.update")) return;
+
+		constexpr uint32_t queryCount = 256;
+		constexpr float queryRadius = 4.0f;
+
+		for (const uint32_t count : settings.entityCounts) {
+			// About one entity per 8 cubic meters whatever the count, so a query finds ~30 of them
+			const float halfExtent = std::cbrt(static_cast<float>(count));
+			std::mt19937 random(2024);
+			std::uniform_real_distribution<float> coordinate(-halfExtent, halfExtent);
+			auto randomPosition = [&]() { return glm::vec3(coordinate(random), coordinate(random), coordinate(random)); };
+
+			ECSOrchestrator ecs;
+			TransformSystem& transformSystem = ecs.AddSystem<TransformSystem>(ecs);
+			SpatialGridSystem& grid = ecs.AddSystem<SpatialGridSystem>(2.0f * queryRadius);
+
+			std::vector<Entity> entities = ecs.CreateEntities(count);
+			for (const Entity entity : entities) {
+				ecs.AddComponent<TransformComponent>(entity, TransformComponent(randomPosition()));
+			}
+			ecs.UpdateEntitiesLifeTime();
+			transformSystem.RunSystem(ecs);
+			grid.RunSystem(ecs);
+
+			std::vector<glm::vec3> centers(queryCount);
+			for (glm::vec3& center : centers) center = randomPosition();
+			std::array<Entity, 256> found;
+			const uint64_t workingSet = static_cast<uint64_t>(count) * (sizeof(Entity) + sizeof(glm::vec3));
+
+			// The same queries answered by walking every WorldTransformComponent, and by the grid
+			if (report.ShouldRun("spatial.query_sphere")) {
+				const auto linearSamples = Sample(settings.samples, []() {}, [&]() {
+					uint64_t total = 0;
+					for (const glm::vec3& center : centers) {
+						size_t hits = 0;
+						for (auto [entity, world] : ecs.View<WorldTransformComponent>()) {
+							const glm::vec3 offset = world.GetPosition() - center;
+							if (glm::dot(offset, offset) <= queryRadius * queryRadius) {
+								if (hits < found.size()) found[hits] = entity;
+								hits++;
+							}
+						}
+						total += hits;
+					}
+					Consume(total);
+					});
+				Record(report, "spatial.query_sphere", "linear", count, queryCount, linearSamples, 0.0, workingSet);
+
+				const auto gridSamples = Sample(settings.samples, []() {}, [&]() {
+					uint64_t total = 0;
+					for (const glm::vec3& center : centers) {
+						total += grid.QuerySphere({ center, queryRadius }, found);
+					}
+					Consume(total);
+					});
+				Record(report, "spatial.query_sphere", "grid", count, queryCount, gridSamples, 0.0, workingSet);
+			}
+
+			// Keeping the grid up to date when 10% of the world moved a little (ns/op per moved entity)
+			if (report.ShouldRun("spatial.update")) {
+				const uint32_t movedCount = std::max(1u, count / 10);
+				std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+				const auto samples = Sample(settings.samples,
+					[&]() {
+						for (uint32_t i = 0; i < movedCount; ++i) {
+							ecs.PatchComponent<TransformComponent>(entities[random() % count]).position += glm::vec3(step(random), step(random), step(random));
+						}
+						transformSystem.RunSystem(ecs);
+					},
+					[&]() { grid.RunSystem(ecs); });
+				Record(report, "spatial.update", "grid", count, movedCount, samples, sizeof(glm::vec3), workingSet);
+			}
+		}
+	}
+
+	// <-------------------------- Render Queue ----------------------------->
+
+	void RunRenderSortBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		if (!report.ShouldRun("render.sort")) return;
+
+		for (const uint32_t count : settings.entityCounts) {
+			// A scene of 8 shaders, 64 textures and 32 meshes (ids are path hashes, like the AssetManager's),
+			// 5% translucent, everything in layer 1 but one skybox in layer 0, submitted in ECS order
+			std::mt19937 random(77);
+			std::vector<uint32_t> shaders(8), textures(64);
+			for (uint32_t& id : shaders) id = random();
+			for (uint32_t& id : textures) id = random();
+			std::uniform_real_distribution<float> distance(0.5f, 500.0f);
+
+			std::vector<RenderCommand> submitted(count);
+			for (uint32_t i = 0; i < count; ++i) {
+				RenderCommand& command = submitted[i];
+				command.layerID = i == 0 ? 0 : 1;
+				command.shaderID = shaders[random() % shaders.size()];
+				command.textureID = textures[random() % textures.size()];
+				command.vao = 1 + random() % 32;
+				command.indexCount = 36;
+				command.depth = distance(random);
+				command.isTranslucent = random() % 20 == 0;
+				command.transform = glm::mat4(1.0f);
+			}
+
+			// The renderer gets a new unsorted queue every frame, so every sample starts from the submission order
+			std::vector<RenderCommand> commands;
+			const auto commandSamples = Sample(settings.samples,
+				[&]() { commands = submitted; },
+				[&]() {
+					std::sort(commands.begin(), commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+						if (a.layerID != b.layerID) return a.layerID < b.layerID;
+						if (a.shaderID != b.shaderID) return a.shaderID < b.shaderID;
+						return a.textureID < b.textureID;
+						});
+					Consume(commands[count / 2].shaderID);
+				});
+			Record(report, "render.sort", "commands_std_sort", count, count, commandSamples, sizeof(RenderCommand),
+				static_cast<uint64_t>(count) * sizeof(RenderCommand));
+
+			// The keys the renderer builds in FuelRenderCommands
+			std::vector<RenderSortEntry> submittedKeys(count);
+			for (uint32_t i = 0; i < count; ++i) {
+				submittedKeys[i] = { RenderSortKey::Make(submitted[i]), i };
+			}
+			std::vector<RenderSortEntry> entries, scratch;
+			const uint64_t keyWorkingSet = static_cast<uint64_t>(count) * 2 * sizeof(RenderSortEntry);
+
+			const auto keySamples = Sample(settings.samples,
+				[&]() { entries = submittedKeys; },
+				[&]() {
+					std::sort(entries.begin(), entries.end(), [](const RenderSortEntry& a, const RenderSortEntry& b) { return a.key < b.key; });
+					Consume(entries[count / 2].index);
+				});
+			Record(report, "render.sort", "keys_std_sort", count, count, keySamples, sizeof(RenderSortEntry), keyWorkingSet);
+
+			const auto radixSamples = Sample(settings.samples,
+				[&]() { entries = submittedKeys; },
+				[&]() {
+					RadixSortRenderEntries(entries, scratch);
+					Consume(entries[count / 2].index);
+				});
+			Record(report, "render.sort", "keys_radix", count, count, radixSamples, sizeof(RenderSortEntry), keyWorkingSet);
+
+			if (!std::is_sorted(entries.begin(), entries.end(), [](const RenderSortEntry& a, const RenderSortEntry& b) { return a.key < b.key; })) {
+				Logger::Err("[Bench]: the radix sort left the render queue unsorted, its timings are meaningless");
+			}
+		}
+	}
+
+	// <-------------------------- Snapshots ----------------------------->
+
+	void RunSnapshotBenches(BenchReport& report, const SuiteSettings& settings)
+	{
+		if (!report.ShouldRun("snapshot.capture") && !report.ShouldRun("snapshot.restore")) return;
+
+		WorldSnapshot::RegisterComponent<BenchComponent<0>>("BenchComponent0");
+		WorldSnapshot::RegisterComponent<BenchComponent<1>>("BenchComponent1");
+		WorldSnapshot::RegisterComponent<BenchName>("BenchName",
+			[](SnapshotWriter& writer, const BenchName& component) { writer.WriteString(component.name); },
+			[](SnapshotReader& reader, BenchName& component) { component.name = reader.ReadString(); });
+
+		for (const uint32_t count : settings.entityCounts) {
+			ECSOrchestrator source;
+			std::vector<Entity> entities = source.CreateEntities(count);
+			for (uint32_t i = 0; i < count; ++i) {
+				source.AddComponent<BenchComponent<0>>(entities[i]);
+				source.AddComponent<BenchComponent<1>>(entities[i]);
+				if (i % 10 == 0) {
+					source.AddComponent<BenchName>(entities[i], BenchName{ "Entity number " + std::to_string(i) });
+				}
+			}
+			source.UpdateEntitiesLifeTime();
+
+			std::vector<std::byte> buffer;
+			bool succeeded = true;
+
+			const auto captureSamples = Sample(settings.samples, []() {}, [&]() { succeeded &= WorldSnapshot::Capture(source, buffer); });
+			const double bytesPerEntity = static_cast<double>(buffer.size()) / count;
+			Record(report, "snapshot.capture", "sparse_set", count, count, captureSamples, bytesPerEntity, buffer.size());
+
+			ECSOrchestrator destination;
+			const auto restoreSamples = Sample(settings.samples, []() {}, [&]() { succeeded &= WorldSnapshot::Restore(destination, buffer); });
+			Record(report, "snapshot.restore", "sparse_set", count, count, restoreSamples, bytesPerEntity, buffer.size());
+
+			if (!succeeded) {
+				Logger::Err("[Bench]: snapshot round trip failed, its timings are meaningless");
+			}
+		}
+	}
+}
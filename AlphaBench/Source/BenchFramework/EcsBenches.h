@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BenchReport.h"
+#include <cstdint>
+#include <vector>
+
+namespace AlphaBench
+{
+	struct SuiteSettings
+	{
+		// Timed runs per case (after one untimed warmup run)
+		uint32_t samples = 15;
+		// Every case runs once per world size
+		std::vector<uint32_t> entityCounts = { 1000, 10000, 100000 };
+	};
+
+	// ComponentPool<T> on its own: AddComp, Get in dense order and in random order, RemoveComp (swap and pop)
+	void RunPoolBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// System::AddEntityToSystem / RemoveEntityFromSystem on their own
+	void RunSystemBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// Whole frames of spawn + destroy + add/remove component against 24 systems, ending in UpdateEntitiesLifeTime.
+	// ns/op is per structural change (spawn, destroy or mutation)
+	void RunLifetimeBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// View<1|2|3 components> on both backends, plus the owning groups of the sparse set backend.
+	// The pools are filled in different orders, like a real world where components come and go
+	void RunIterationBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// Signature matching: the old std::bitset path, the Signature::Contains loop and the SignatureMatch.h SIMD kernel side by side.
+	// match_entities -> one query against every entity signature, match_systems -> every entity against 64 system requirements
+	void RunSignatureBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// World matrices: TransformComponent::GetTransform one by one against the ComposeTransforms kernel (transform.compose),
+	// and a whole TransformSystem run with every root moved in the AoS and SoA layouts (transform.system)
+	void RunTransformBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// Neighbourhood queries: 256 sphere queries (~30 hits each) by walking every WorldTransformComponent against the
+	// SpatialGridSystem (spatial.query_sphere, ns/op per query), and the grid's update after 10% of the world moved (spatial.update)
+	void RunSpatialBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// Render queue ordering, one command per entity: std::sort of the RenderCommands themselves with the old
+	// layer/shader/texture comparator, against 64 bit RenderSortKeys sorted with std::sort and with the radix sort.
+	// Every sample sorts a fresh queue in submission order (the renderer builds the keys on submission), ns/op is per command
+	void RunRenderSortBenches(BenchReport& report, const SuiteSettings& settings);
+
+	// WorldSnapshot::Capture and Restore round trip: two trivially copyable pools + 10% string components.
+	// ns/op is per entity
+	void RunSnapshotBenches(BenchReport& report, const SuiteSettings& settings);
+}
@@ -0,0 +1,72 @@
+#include "BenchReport.h"
+#include "EcsBenches.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// AlphaEngineBench [--json <path>] [--samples <n>] [--filter <text>] [--quick]
+//
+// --json    where the report goes (default AlphaEngineBench.json). Not stdout, the engine logs there
+// --samples timed runs per case (default 15)
+// --filter  only the cases whose name contains the text, e.g. --filter iterate.
+// --quick   5 samples and no 100k worlds, for a fast check before a PR
+//
+// Report layout:
+// { "suite": "AlphaEngineBench", "build": "release", "samples_per_case": 15,
+//   "results": [ { "name": "pool.get_random", "backend": "sparse_set", "entities": 10000, "operations": 10000, "samples": 15,
+//                  "ns_per_op": { "median", "min", "p90", "mean", "stddev" },
+//                  "bytes_per_op", "working_set_bytes", "gb_per_s" }, ... ] }
+//
+// Compare the median ns/op of a case between two reports. Only trust release builds.
+int main(int argc, char** argv)
+{
+	AlphaBench::SuiteSettings settings;
+	std::string jsonPath = "AlphaEngineBench.json";
+	std::string filter;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (argument == "--json" && hasValue) jsonPath = argv[++i];
+		else if (argument == "--samples" && hasValue) settings.samples = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+		else if (argument == "--filter" && hasValue) filter = argv[++i];
+		else if (argument == "--quick") {
+			settings.samples = 5;
+			settings.entityCounts = { 1000, 10000 };
+		}
+		else {
+			std::fprintf(stderr, "Unknown argument '%s'\nUsage: AlphaEngineBench [--json <path>] [--samples <n>] [--filter <text>] [--quick]\n", argument.c_str());
+			return 1;
+		}
+	}
+
+	AlphaBench::BenchReport report(filter);
+	AlphaBench::RunPoolBenches(report, settings);
+	AlphaBench::RunSystemBenches(report, settings);
+	AlphaBench::RunLifetimeBenches(report, settings);
+	AlphaBench::RunIterationBenches(report, settings);
+	AlphaBench::RunSignatureBenches(report, settings);
+	AlphaBench::RunTransformBenches(report, settings);
+	AlphaBench::RunSpatialBenches(report, settings);
+	AlphaBench::RunRenderSortBenches(report, settings);
+	AlphaBench::RunSnapshotBenches(report, settings);
+
+	std::cout << "\n";
+	report.PrintTable(std::cout);
+
+	std::ofstream json(jsonPath);
+	if (!json) {
+		std::fprintf(stderr, "Can't write the report to '%s'\n", jsonPath.c_str());
+		return 1;
+	}
+	report.WriteJson(json, settings.samples);
+	std::cout << "\nReport written to " << jsonPath << "\n";
+
+#ifndef NDEBUG
+	std::cout << "Warning: debug build, the timings are not representative\n";
+#endif
+	return 0;
+}
@@ -14,6 +14,15 @@
 #include "EngineFramework/WindowEvents.h"
 #include "EngineFramework/EventBus.h"
 #include "EngineFramework/ServiceLocator.h"
+#include "EngineFramework/ECS/WorldSnapshot.h"
+#include "EngineFramework/Components/TransformComponent.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
+#include "EngineFramework/Components/HierarchyComponent.h"
+#include "EngineFramework/Components/RendererComponent.h"
+#include "EngineFramework/Components/CameraComponent.h"
+#include "EngineFramework/Components/PlayerControllerComponent.h"
+#include "EngineFramework/Components/VelocityComponent.h"
+#include "EngineFramework/Components/RigidBodyComponent.h"
 #include <cstdint>
 
 
@@ -49,7 +58,18 @@ namespace AlphaEngine
 		m_Renderer = std::make_unique<OpenGLRenderer>();
 		m_Renderer->OnWindowResize(m_Window->GetWidth(), m_Window->GetHeight());
 
-		m_OrchestratorECS = std::make_unique<ECSOrchestrator>();
+		m_OrchestratorECS = std::make_unique<ECSOrchestrator>(m_Specification.ecsStorageBackend);
+
+		// The names are what a snapshot file stores, don't rename them or old snapshots stop loading
+		WorldSnapshot::RegisterComponent<TransformComponent>("TransformComponent");
+		WorldSnapshot::RegisterComponent<WorldTransformComponent>("WorldTransformComponent");
+		WorldSnapshot::RegisterComponent<HierarchyComponent>("HierarchyComponent");
+		WorldSnapshot::RegisterComponent<RenderComponent>("RenderComponent");
+		WorldSnapshot::RegisterComponent<CameraComponent>("CameraComponent");
+		WorldSnapshot::RegisterComponent<PlayerControllerComponent>("PlayerControllerComponent");
+		WorldSnapshot::RegisterComponent<VelocityComponent>("VelocityComponent");
+		// The BodyIDs only mean something while the same Jolt bodies exist (level restart / rollback in the same session)
+		WorldSnapshot::RegisterComponent<RigidBodyComponent>("RigidBodyComponent");
 
 		m_Input = std::make_unique<Input>(m_Window->GetHandle());
 
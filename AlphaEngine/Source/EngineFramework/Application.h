@@ -19,6 +19,9 @@ namespace AlphaEngine {
 	struct ApplicationSpecification {
 		std::string Name = "Application";
 		WindowSpecification windowSpec;
+
+		// Sparse sets by default, Archetype packs same-signature entities into chunks
+		ECSStorageBackend ecsStorageBackend = ECSStorageBackend::SparseSet;
 	};
 
 	class Application
@@ -295,10 +295,6 @@ namespace AlphaEngine
 		assetMesh->mesh->SetData(std::move(vertices), std::move(indices));
 		assetMesh->mesh->SetupMesh();
 
-		uint32_t vao = assetMesh->mesh->GetMesh();
-		uint32_t instanceVBO = assetMesh->mesh->GetInstanceVBO();
-		m_VAOToInstanceVBO[vao] = instanceVBO;
-
 		assetMesh->isLoading = false;
 		assetMesh->isReady = true;
 		std::cout << "Upload Mesh Addr: " << assetMesh->mesh.get() << std::endl;
@@ -393,16 +389,6 @@ namespace AlphaEngine
 		return 0;
 	}
 
-	// Get Instance VBO
-	uint32_t AssetManager::GetMeshInstanceVBO(uint32_t vaoID)
-	{
-		auto it = m_VAOToInstanceVBO.find(vaoID);
-		if (it != m_VAOToInstanceVBO.end()) {
-			return it->second;
-		}
-		return 0;
-	}
-
 	float AssetManager::GetMeshRadius(AssetHandler handle)
 	{
 		if (m_MeshesLibrary.count(handle.id)) {
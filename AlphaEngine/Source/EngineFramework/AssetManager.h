@@ -144,9 +144,6 @@ namespace AlphaEngine
 		// A queue that have all of our JObs
 		std::queue< std::unique_ptr<IUploadJob>> m_UploadQueueJobs;
 
-		// A map with VAO ID TO INSTANCE VBO ID
-		std::unordered_map<uint32_t, uint32_t> m_VAOToInstanceVBO;
-
 		// Mutex (Mutual Exclusion): Think of it like a key for your data. If 2 threads try to change
 		// the same std::queue for example at the exact same time, the program will crash.
 		// UploadQueue is the vault and queueMutex is the key
@@ -190,8 +187,6 @@ namespace AlphaEngine
 		uint32_t GetMeshVAO(AssetHandler handle);
 		// Get Mesh Indices
 		uint32_t GetMeshIndexCount(AssetHandler handle);
-		// Get VBO
-		uint32_t GetMeshInstanceVBO(uint32_t vaoID);
 		// Get Mesh Radius
 		float GetMeshRadius(AssetHandler handle);
 		// Get All indices
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "EngineFramework/ECS/ECSTypes.h"
+#include <cstdint>
+
+namespace AlphaEngine
+{
+	// Parent/child links, the children of an entity are an intrusive linked list:
+	//
+	// Car | firstChild -> WheelFL <-> WheelFR <-> WheelRL <-> WheelRR
+	//
+	// so attaching/detaching is O(1) and there is no std::vector per entity.
+	// Don't edit the links by hand, use TransformSystem::SetParent/Detach.
+	// The TransformComponent of a child is relative to its parent.
+	struct HierarchyComponent
+	{
+		Entity parent;
+		Entity firstChild;
+		Entity prevSibling;
+		Entity nextSibling;
+		uint32_t childCount = 0;
+	};
+}
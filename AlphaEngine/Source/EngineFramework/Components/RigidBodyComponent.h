@@ -8,5 +8,8 @@ namespace AlphaEngine
 {
     struct RigidBodyComponent {
         JPH::BodyID bodyID;  
+
+        // Whether the body was awake on the last sync, used to skip sleeping bodies
+        bool wasActive = true;
     };
 }
\ No newline at end of file
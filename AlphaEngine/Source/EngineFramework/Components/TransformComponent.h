@@ -8,6 +8,8 @@
 
 namespace AlphaEngine {
 
+	// Local position/rotation/scale. After writing it call ecs.MarkChanged<TransformComponent>(entity)
+	// (or use PatchComponent), that's how the TransformSystem knows the world matrix is out of date
 	struct TransformComponent
 	{
 		glm::vec3 position;
@@ -18,18 +20,21 @@ namespace AlphaEngine {
 			: position(pos), scale(sc), rotation(rot) {
 		}
 
+		// The local matrix (Translation * Rotation * Scale), relative to the parent if the entity has one.
+		// Built straight from the quaternion instead of multiplying three mat4s.
+		// Don't call it every frame for rendering, the TransformSystem caches the world matrix in the WorldTransformComponent
 		glm::mat4 GetTransform() const {
 
-			// Translation
-			glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), position);
-
-			// Rotation
-			glm::mat4 rotationMat = glm::toMat4(rotation);
+			// Rotation, with every axis scaled
+			glm::mat4 transform = glm::toMat4(rotation);
+			transform[0] *= scale.x;
+			transform[1] *= scale.y;
+			transform[2] *= scale.z;
 
-			// Scaling
-			glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), scale);
+			// Translation
+			transform[3] = glm::vec4(position, 1.0f);
 
-			return translationMat * rotationMat * scaleMat;
+			return transform;
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace AlphaEngine
+{
+	// The world matrix of an entity (parent world * local), written by the TransformSystem.
+	// Every entity with a TransformComponent gets one automatically.
+	// Render, camera and physics read this instead of recomposing the TransformComponent every time
+	struct WorldTransformComponent
+	{
+		glm::mat4 matrix = glm::mat4(1.0f);
+
+		inline glm::vec3 GetPosition() const { return glm::vec3(matrix[3]); }
+
+		// Biggest axis scale, e.g. to scale a bounding sphere
+		inline float GetMaxScale() const
+		{
+			const float x = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+			const float y = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+			const float z = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
+			return glm::sqrt(glm::max(x, glm::max(y, z)));
+		}
+
+		// The scale is taken out of the axes first, quat_cast only works on a pure rotation
+		inline glm::quat GetRotation() const
+		{
+			const glm::mat3 rotation(glm::normalize(glm::vec3(matrix[0])), glm::normalize(glm::vec3(matrix[1])), glm::normalize(glm::vec3(matrix[2])));
+			return glm::quat_cast(rotation);
+		}
+	};
+}
@@ -0,0 +1,332 @@
+#include "EngineFramework/ECS/Archetype.h"
+#include <algorithm>
+
+namespace AlphaEngine
+{
+	static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	Archetype::Archetype(const Signature& signature)
+		: m_Signature(signature)
+	{
+		m_ColumnOfComponent.fill(-1);
+		m_AddEdges.fill(INVALID_ARCHETYPE);
+		m_RemoveEdges.fill(INVALID_ARCHETYPE);
+
+		for (uint16_t componentId = 0; componentId < MAX_COMPONENTS; ++componentId) {
+			if (signature.test(componentId)) {
+				m_ColumnOfComponent[componentId] = static_cast<int16_t>(m_ComponentIds.size());
+				m_ComponentIds.push_back(componentId);
+			}
+		}
+		m_ColumnOffsets.resize(m_ComponentIds.size());
+		m_AddedTickOffsets.resize(m_ComponentIds.size());
+		m_ChangedTickOffsets.resize(m_ComponentIds.size());
+
+		// How many bytes one row needs (the entity + one of each component + their two ticks)
+		uint32_t rowBytes = sizeof(Entity);
+		for (uint16_t componentId : m_ComponentIds) {
+			rowBytes += IComponent::GetTypeInfo(componentId).size + 2 * sizeof(uint32_t);
+		}
+
+		// Big components could not even fit once, in that case the chunk grows to hold exactly one row
+		m_ChunkCapacity = std::max(1u, ARCHETYPE_CHUNK_SIZE / rowBytes);
+
+		// Padding between columns can push us over the chunk size, so shrink until the layout fits
+		while (true) {
+			uint32_t offset = m_ChunkCapacity * sizeof(Entity);
+			for (size_t column = 0; column < m_ComponentIds.size(); ++column) {
+				const ComponentTypeInfo& info = IComponent::GetTypeInfo(m_ComponentIds[column]);
+				offset = AlignUp(offset, info.alignment);
+				m_ColumnOffsets[column] = offset;
+				offset += m_ChunkCapacity * info.size;
+			}
+
+			// The tick columns go after all the component data
+			offset = AlignUp(offset, alignof(uint32_t));
+			for (size_t column = 0; column < m_ComponentIds.size(); ++column) {
+				m_AddedTickOffsets[column] = offset;
+				offset += m_ChunkCapacity * sizeof(uint32_t);
+				m_ChangedTickOffsets[column] = offset;
+				offset += m_ChunkCapacity * sizeof(uint32_t);
+			}
+
+			if (offset <= ARCHETYPE_CHUNK_SIZE || m_ChunkCapacity == 1) {
+				m_ChunkBytes = AlignUp(std::max(offset, ARCHETYPE_CHUNK_SIZE), ARCHETYPE_CHUNK_ALIGNMENT);
+				break;
+			}
+			m_ChunkCapacity--;
+		}
+	}
+
+	Archetype::~Archetype()
+	{
+		// Components can own resources, so destruct whatever is still alive before freeing the chunks
+		for (uint32_t row = 0; row < m_Count; ++row) {
+			for (uint16_t componentId : m_ComponentIds) {
+				IComponent::GetTypeInfo(componentId).destruct(GetComponent(row, componentId));
+			}
+		}
+
+		for (auto& chunk : m_Chunks) {
+			::operator delete(chunk.memory, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+		}
+	}
+
+	ArchetypeChunk& Archetype::AllocateChunk()
+	{
+		ArchetypeChunk chunk;
+		chunk.memory = static_cast<std::byte*>(::operator new(m_ChunkBytes, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT)));
+		chunk.count = 0;
+		m_Chunks.push_back(chunk);
+		return m_Chunks.back();
+	}
+
+	uint32_t Archetype::PushEntity(Entity entity)
+	{
+		// Rows are always packed, so only the last chunk can have free space
+		if (m_Chunks.empty() || m_Chunks.back().count == m_ChunkCapacity) {
+			AllocateChunk();
+		}
+
+		ArchetypeChunk& chunk = m_Chunks.back();
+		new (reinterpret_cast<Entity*>(chunk.memory) + chunk.count) Entity(entity);
+		chunk.count++;
+
+		return m_Count++;
+	}
+
+	Entity Archetype::RemoveRow(uint32_t row)
+	{
+		assert(row < m_Count);
+
+		const uint32_t lastRow = m_Count - 1;
+		Entity movedEntity;
+
+		for (uint16_t componentId : m_ComponentIds) {
+			const ComponentTypeInfo& info = IComponent::GetTypeInfo(componentId);
+			void* hole = GetComponent(row, componentId);
+			info.destruct(hole);
+
+			// Swap and Pop, the last row fills the hole so the chunks stay packed
+			if (row != lastRow) {
+				void* last = GetComponent(lastRow, componentId);
+				info.moveConstruct(hole, last);
+				info.destruct(last);
+
+				AddedTick(row, componentId) = AddedTick(lastRow, componentId);
+				ChangedTick(row, componentId) = ChangedTick(lastRow, componentId);
+			}
+		}
+
+		if (row != lastRow) {
+			movedEntity = GetEntity(lastRow);
+			GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity] = movedEntity;
+		}
+
+		m_Count--;
+		ArchetypeChunk& lastChunk = m_Chunks.back();
+		lastChunk.count--;
+
+		// Give the memory back once a chunk is empty, but keep the first one around
+		// so an archetype that keeps gaining and losing one entity doesn't allocate every time
+		if (lastChunk.count == 0 && m_Chunks.size() > 1) {
+			::operator delete(lastChunk.memory, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+			m_Chunks.pop_back();
+		}
+
+		return movedEntity;
+	}
+
+	void Archetype::RemapEntities(std::span<const Entity> newHandles)
+	{
+		for (uint32_t chunkIndex = 0; chunkIndex < m_Chunks.size(); ++chunkIndex) {
+			Entity* entities = GetEntities(chunkIndex);
+			for (uint32_t slot = 0; slot < m_Chunks[chunkIndex].count; ++slot) {
+				entities[slot] = newHandles[entities[slot].GetIndex()];
+			}
+		}
+	}
+
+	void Archetype::ReleaseEmptyChunks()
+	{
+		if (m_Count != 0) return;
+
+		for (auto& chunk : m_Chunks) {
+			::operator delete(chunk.memory, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+		}
+		m_Chunks.clear();
+		m_Chunks.shrink_to_fit();
+	}
+
+	void ArchetypeStorage::RemapEntities(std::span<const Entity> newHandles, uint32_t newEntityCount)
+	{
+		std::vector<EntityLocation> locations(newEntityCount);
+		const size_t oldEntityCount = std::min(m_EntityLocations.size(), newHandles.size());
+		for (size_t oldIndex = 0; oldIndex < oldEntityCount; ++oldIndex) {
+			if (m_EntityLocations[oldIndex].archetype == INVALID_ARCHETYPE) continue;
+			locations[newHandles[oldIndex].GetIndex()] = m_EntityLocations[oldIndex];
+		}
+		m_EntityLocations = std::move(locations);
+
+		for (auto& archetype : m_Archetypes) {
+			archetype->RemapEntities(newHandles);
+			archetype->ReleaseEmptyChunks();
+		}
+	}
+
+	size_t ArchetypeStorage::GetMemoryUsage() const
+	{
+		size_t bytes = m_EntityLocations.capacity() * sizeof(EntityLocation);
+		for (const auto& archetype : m_Archetypes) {
+			bytes += static_cast<size_t>(archetype->GetChunkCount()) * archetype->GetChunkBytes();
+		}
+		return bytes;
+	}
+
+	uint32_t ArchetypeStorage::FindOrCreateArchetype(const Signature& signature)
+	{
+		auto it = m_ArchetypeLookup.find(signature);
+		if (it != m_ArchetypeLookup.end()) {
+			return it->second;
+		}
+
+		const uint32_t index = static_cast<uint32_t>(m_Archetypes.size());
+		m_Archetypes.push_back(std::make_unique<Archetype>(signature));
+		m_Signatures.push_back(signature);
+		m_ArchetypeLookup.emplace(signature, index);
+		return index;
+	}
+
+	void ArchetypeStorage::PushNewEntities(std::span<const Entity> entities, const Signature& signature)
+	{
+		if (entities.empty() || signature.none()) return;
+
+		uint32_t maxEntityId = 0;
+		for (const Entity& entity : entities) {
+			maxEntityId = std::max(maxEntityId, entity.GetIndex());
+		}
+		if (maxEntityId >= m_EntityLocations.size()) {
+			m_EntityLocations.resize(maxEntityId + 1);
+		}
+
+		const uint32_t archetypeIndex = FindOrCreateArchetype(signature);
+		Archetype& archetype = *m_Archetypes[archetypeIndex];
+		for (const Entity& entity : entities) {
+			assert(m_EntityLocations[entity.GetIndex()].archetype == INVALID_ARCHETYPE && "PushNewEntities only takes entities without components");
+			m_EntityLocations[entity.GetIndex()] = { archetypeIndex, archetype.PushEntity(entity) };
+		}
+	}
+
+	uint32_t ArchetypeStorage::GetArchetypeWith(uint32_t archetype, uint16_t componentId)
+	{
+		if (archetype == INVALID_ARCHETYPE) {
+			Signature signature;
+			signature.set(componentId);
+			return FindOrCreateArchetype(signature);
+		}
+
+		uint32_t target = m_Archetypes[archetype]->GetAddEdge(componentId);
+		if (target == INVALID_ARCHETYPE) {
+			Signature signature = m_Archetypes[archetype]->GetSignature();
+			signature.set(componentId);
+			target = FindOrCreateArchetype(signature);
+
+			// Careful: FindOrCreateArchetype can grow m_Archetypes, so index again
+			m_Archetypes[archetype]->SetAddEdge(componentId, target);
+			m_Archetypes[target]->SetRemoveEdge(componentId, archetype);
+		}
+		return target;
+	}
+
+	uint32_t ArchetypeStorage::GetArchetypeWithout(uint32_t archetype, uint16_t componentId)
+	{
+		uint32_t target = m_Archetypes[archetype]->GetRemoveEdge(componentId);
+		if (target == INVALID_ARCHETYPE) {
+			Signature signature = m_Archetypes[archetype]->GetSignature();
+			signature.set(componentId, false);
+
+			// An entity without components doesn't need to live in any archetype
+			if (signature.none()) {
+				return INVALID_ARCHETYPE;
+			}
+
+			target = FindOrCreateArchetype(signature);
+			m_Archetypes[archetype]->SetRemoveEdge(componentId, target);
+			m_Archetypes[target]->SetAddEdge(componentId, archetype);
+		}
+		return target;
+	}
+
+	EntityLocation ArchetypeStorage::MoveEntity(Entity entity, uint32_t targetArchetype)
+	{
+		const auto entityId = entity.GetIndex();
+		const EntityLocation current = m_EntityLocations[entityId];
+
+		if (current.archetype == targetArchetype) {
+			return current;
+		}
+
+		EntityLocation next;
+		next.archetype = targetArchetype;
+
+		if (targetArchetype != INVALID_ARCHETYPE) {
+			Archetype& destination = *m_Archetypes[targetArchetype];
+			next.row = destination.PushEntity(entity);
+
+			// Move over everything the two archetypes have in common
+			if (current.archetype != INVALID_ARCHETYPE) {
+				Archetype& source = *m_Archetypes[current.archetype];
+				for (uint16_t componentId = 0; componentId < MAX_COMPONENTS; ++componentId) {
+					if (source.HasComponent(componentId) && destination.HasComponent(componentId)) {
+						IComponent::GetTypeInfo(componentId).moveConstruct(
+							destination.GetComponent(next.row, componentId),
+							source.GetComponent(current.row, componentId));
+
+						// Moving between archetypes is not a change
+						destination.AddedTick(next.row, componentId) = source.AddedTick(current.row, componentId);
+						destination.ChangedTick(next.row, componentId) = source.ChangedTick(current.row, componentId);
+					}
+				}
+			}
+		}
+
+		// Free the old row, this destroys the moved-from objects and the ones the entity lost
+		if (current.archetype != INVALID_ARCHETYPE) {
+			Entity movedEntity = m_Archetypes[current.archetype]->RemoveRow(current.row);
+			if (movedEntity.IsValid()) {
+				m_EntityLocations[movedEntity.GetIndex()].row = current.row;
+			}
+		}
+
+		m_EntityLocations[entityId] = next;
+		return next;
+	}
+
+	void ArchetypeStorage::Remove(Entity entity, uint16_t componentId)
+	{
+		const auto entityId = entity.GetIndex();
+		if (entityId >= m_EntityLocations.size()) return;
+
+		const EntityLocation current = m_EntityLocations[entityId];
+		if (current.archetype == INVALID_ARCHETYPE || !m_Archetypes[current.archetype]->HasComponent(componentId)) return;
+
+		MoveEntity(entity, GetArchetypeWithout(current.archetype, componentId));
+	}
+
+	void ArchetypeStorage::RemoveEntity(uint32_t entityIndex)
+	{
+		if (entityIndex >= m_EntityLocations.size()) return;
+
+		const EntityLocation current = m_EntityLocations[entityIndex];
+		if (current.archetype == INVALID_ARCHETYPE) return;
+
+		Entity movedEntity = m_Archetypes[current.archetype]->RemoveRow(current.row);
+		if (movedEntity.IsValid()) {
+			m_EntityLocations[movedEntity.GetIndex()].row = current.row;
+		}
+		m_EntityLocations[entityIndex] = EntityLocation();
+	}
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include "EngineFramework/ECS/ECSTypes.h"
+
+namespace AlphaEngine
+{
+	// <-------------------------- Archetype Storage ----------------------------->
+	//
+	// The sparse set pools keep every component type in its own array, so a system that needs
+	// Transform + Render jumps between two unrelated arrays for every entity.
+	// An Archetype groups ALL the entities that have the exact same Signature and stores their
+	// components side by side in fixed size chunks:
+	//
+	// Chunk (16 KB) | [Entity 0..N] [Transform 0..N] [Render 0..N]
+	//
+	// Row i of every column belongs to the same entity, so iterating Transform + Render
+	// is just walking two arrays linearly inside the same block of memory.
+	// Every component column also gets two uint32 tick columns (added / changed) at the end of the chunk,
+	// they are only read by Views that filter on Changed<T>/Added<T>.
+
+	static constexpr uint32_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+	static constexpr uint32_t ARCHETYPE_CHUNK_ALIGNMENT = 64;
+	static constexpr uint32_t INVALID_ARCHETYPE = 0xFFFFFFFF;
+
+	struct ArchetypeChunk
+	{
+		std::byte* memory = nullptr;
+		uint32_t count = 0;
+	};
+
+	class Archetype
+	{
+	private:
+		Signature m_Signature;
+
+		// The component ids this archetype stores (one column each)
+		std::vector<uint16_t> m_ComponentIds;
+
+		// Byte offset of each column inside a chunk, same order as m_ComponentIds
+		std::vector<uint32_t> m_ColumnOffsets;
+		std::vector<uint32_t> m_AddedTickOffsets;
+		std::vector<uint32_t> m_ChangedTickOffsets;
+
+		// component id -> column index, -1 when the archetype doesn't have that component
+		std::array<int16_t, MAX_COMPONENTS> m_ColumnOfComponent;
+
+		// Cached transitions, so adding/removing a component doesn't have to hash a signature
+		// [index = component id, value = archetype index inside the storage]
+		std::array<uint32_t, MAX_COMPONENTS> m_AddEdges;
+		std::array<uint32_t, MAX_COMPONENTS> m_RemoveEdges;
+
+		std::vector<ArchetypeChunk> m_Chunks;
+		uint32_t m_ChunkCapacity = 0;
+		uint32_t m_ChunkBytes = ARCHETYPE_CHUNK_SIZE;
+		uint32_t m_Count = 0;
+
+		ArchetypeChunk& AllocateChunk();
+
+	public:
+		Archetype(const Signature& signature);
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		// Appends the entity at the end of the archetype and returns its row.
+		// The component slots of that row are left uninitialized for the caller to construct.
+		uint32_t PushEntity(Entity entity);
+
+		// Destroys the components of the row and moves the last row into the hole (swap and pop)
+		// Returns the entity that was moved into 'row', or a Null entity if nothing moved
+		Entity RemoveRow(uint32_t row);
+
+		// Compact(): every entity of the entity column becomes newHandles[its old index]
+		void RemapEntities(std::span<const Entity> newHandles);
+
+		// Frees the chunk RemoveRow keeps around once the archetype is empty
+		void ReleaseEmptyChunks();
+
+		inline bool HasComponent(uint16_t componentId) const { return m_ColumnOfComponent[componentId] != -1; }
+
+		inline void* GetComponent(uint32_t row, uint16_t componentId) const
+		{
+			const int16_t column = m_ColumnOfComponent[componentId];
+			assert(column != -1 && "Archetype doesn't store this component!");
+
+			const ArchetypeChunk& chunk = m_Chunks[row / m_ChunkCapacity];
+			const uint32_t slot = row % m_ChunkCapacity;
+			return chunk.memory + m_ColumnOffsets[column] + slot * IComponent::GetTypeInfo(componentId).size;
+		}
+
+		inline uint32_t* GetAddedTicks(uint32_t chunkIndex, uint16_t componentId) const
+		{
+			return reinterpret_cast<uint32_t*>(m_Chunks[chunkIndex].memory + m_AddedTickOffsets[m_ColumnOfComponent[componentId]]);
+		}
+
+		inline uint32_t* GetChangedTicks(uint32_t chunkIndex, uint16_t componentId) const
+		{
+			return reinterpret_cast<uint32_t*>(m_Chunks[chunkIndex].memory + m_ChangedTickOffsets[m_ColumnOfComponent[componentId]]);
+		}
+
+		inline uint32_t& AddedTick(uint32_t row, uint16_t componentId) const { return GetAddedTicks(row / m_ChunkCapacity, componentId)[row % m_ChunkCapacity]; }
+		inline uint32_t& ChangedTick(uint32_t row, uint16_t componentId) const { return GetChangedTicks(row / m_ChunkCapacity, componentId)[row % m_ChunkCapacity]; }
+
+		// Raw column access for linear iteration inside one chunk
+		template <typename T>
+		inline T* GetColumn(uint32_t chunkIndex) const
+		{
+			const int16_t column = m_ColumnOfComponent[Component<T>::GetId()];
+			assert(column != -1 && "Archetype doesn't store this component!");
+			return reinterpret_cast<T*>(m_Chunks[chunkIndex].memory + m_ColumnOffsets[column]);
+		}
+
+		inline Entity* GetEntities(uint32_t chunkIndex) const { return reinterpret_cast<Entity*>(m_Chunks[chunkIndex].memory); }
+		inline Entity GetEntity(uint32_t row) const { return GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity]; }
+
+		inline const Signature& GetSignature() const { return m_Signature; }
+		inline uint32_t GetCount() const { return m_Count; }
+		inline uint32_t GetChunkCount() const { return static_cast<uint32_t>(m_Chunks.size()); }
+		inline uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+		inline uint32_t GetChunkBytes() const { return m_ChunkBytes; }
+		inline const ArchetypeChunk& GetChunk(uint32_t chunkIndex) const { return m_Chunks[chunkIndex]; }
+
+		inline uint32_t GetAddEdge(uint16_t componentId) const { return m_AddEdges[componentId]; }
+		inline uint32_t GetRemoveEdge(uint16_t componentId) const { return m_RemoveEdges[componentId]; }
+		inline void SetAddEdge(uint16_t componentId, uint32_t archetype) { m_AddEdges[componentId] = archetype; }
+		inline void SetRemoveEdge(uint16_t componentId, uint32_t archetype) { m_RemoveEdges[componentId] = archetype; }
+	};
+
+	// Where an entity lives inside the archetype storage
+	struct EntityLocation
+	{
+		uint32_t archetype = INVALID_ARCHETYPE;
+		uint32_t row = 0;
+	};
+
+	class ArchetypeStorage
+	{
+	private:
+		std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+
+		// Signature -> index in m_Archetypes
+		std::unordered_map<Signature, uint32_t> m_ArchetypeLookup;
+		// The signature of every archetype again, packed, so a query can match them all with SignatureMatch.h
+		// [vector index = index in m_Archetypes]
+		std::vector<Signature> m_Signatures;
+
+		// [vector index = entity index]
+		std::vector<EntityLocation> m_EntityLocations;
+
+		uint32_t FindOrCreateArchetype(const Signature& signature);
+
+		// Follows (or creates) the cached edge for adding/removing a single component
+		uint32_t GetArchetypeWith(uint32_t archetype, uint16_t componentId);
+		uint32_t GetArchetypeWithout(uint32_t archetype, uint16_t componentId);
+
+		// Moves the entity into another archetype.
+		// Components that exist in both archetypes are moved, components that only exist in the old one
+		// are destroyed, and components that only exist in the new one are left for the caller to construct
+		EntityLocation MoveEntity(Entity entity, uint32_t targetArchetype);
+
+		// Constructs T in a row that was just moved into, or overwrites it if the entity already had a T
+		template <typename T>
+		static void PlaceComponent(Archetype& archetype, uint32_t row, const Signature& previousSignature, T&& component, uint32_t tick)
+		{
+			// Tags are only a bit in the orchestrator's signature, no column
+			if constexpr (!IsTagComponent<T>) {
+				const uint16_t componentId = static_cast<uint16_t>(Component<T>::GetId());
+				void* slot = archetype.GetComponent(row, componentId);
+
+				if (previousSignature.test(componentId)) {
+					*static_cast<T*>(slot) = std::move(component);
+				}
+				else {
+					new (slot) T(std::move(component));
+					archetype.AddedTick(row, componentId) = tick;
+				}
+				archetype.ChangedTick(row, componentId) = tick;
+			}
+		}
+
+	public:
+		ArchetypeStorage() { m_EntityLocations.reserve(10000); }
+
+		template <typename T, typename ...TArgs>
+		T& Add(Entity entity, uint32_t tick, TArgs&& ...args)
+		{
+			static_assert(!IsTagComponent<T>, "Tags don't get an archetype column");
+			const uint16_t componentId = static_cast<uint16_t>(Component<T>::GetId());
+			const auto entityId = entity.GetIndex();
+
+			if (entityId >= m_EntityLocations.size()) {
+				m_EntityLocations.resize(entityId + 1);
+			}
+
+			const EntityLocation current = m_EntityLocations[entityId];
+
+			// Already there? Then just overwrite the value, no structural change
+			if (current.archetype != INVALID_ARCHETYPE && m_Archetypes[current.archetype]->HasComponent(componentId)) {
+				T& existing = *static_cast<T*>(m_Archetypes[current.archetype]->GetComponent(current.row, componentId));
+				existing = T(std::forward<TArgs>(args)...);
+				m_Archetypes[current.archetype]->ChangedTick(current.row, componentId) = tick;
+				return existing;
+			}
+
+			const EntityLocation location = MoveEntity(entity, GetArchetypeWith(current.archetype, componentId));
+			Archetype& archetype = *m_Archetypes[location.archetype];
+			archetype.AddedTick(location.row, componentId) = tick;
+			archetype.ChangedTick(location.row, componentId) = tick;
+
+			void* slot = archetype.GetComponent(location.row, componentId);
+			return *new (slot) T(std::forward<TArgs>(args)...);
+		}
+
+		// Adds all the Ts to every entity, each entity moves to its final archetype ONCE
+		// (instead of once per component). Entities coming from the same archetype share the lookup.
+		template <typename ...Ts>
+		void AddBatch(std::span<const Entity> entities, uint32_t tick, std::span<Ts>... components)
+		{
+			// The tags of the batch don't move anything
+			Signature addedSignature;
+			((IsTagComponent<Ts> ? void() : void(addedSignature.set(Component<Ts>::GetId()))), ...);
+			if (addedSignature.none()) return;
+
+			uint32_t maxEntityId = 0;
+			for (const Entity& entity : entities) {
+				maxEntityId = std::max(maxEntityId, entity.GetIndex());
+			}
+			if (!entities.empty() && maxEntityId >= m_EntityLocations.size()) {
+				m_EntityLocations.resize(maxEntityId + 1);
+			}
+
+			bool hasCachedTarget = false;
+			uint32_t cachedSource = INVALID_ARCHETYPE;
+			uint32_t cachedTarget = INVALID_ARCHETYPE;
+
+			for (size_t i = 0; i < entities.size(); ++i) {
+				const EntityLocation current = m_EntityLocations[entities[i].GetIndex()];
+				const Signature previousSignature = current.archetype == INVALID_ARCHETYPE ? Signature() : m_Archetypes[current.archetype]->GetSignature();
+
+				if (!hasCachedTarget || current.archetype != cachedSource) {
+					cachedSource = current.archetype;
+					cachedTarget = FindOrCreateArchetype(previousSignature | addedSignature);
+					hasCachedTarget = true;
+				}
+
+				const EntityLocation location = MoveEntity(entities[i], cachedTarget);
+				Archetype& archetype = *m_Archetypes[location.archetype];
+				(PlaceComponent<Ts>(archetype, location.row, previousSignature, std::move(components[i]), tick), ...);
+			}
+		}
+
+		// Puts entities that have no component yet straight into the archetype of 'signature' (tags excluded),
+		// no archetype hops. Their component slots are left uninitialized, ConstructNew<T> fills them
+		void PushNewEntities(std::span<const Entity> entities, const Signature& signature);
+
+		// Constructs T in the row of an entity placed by PushNewEntities
+		template <typename T, typename U>
+		void ConstructNew(uint32_t entityId, uint32_t tick, U&& value)
+		{
+			const EntityLocation& location = m_EntityLocations[entityId];
+			PlaceComponent<T>(*m_Archetypes[location.archetype], location.row, Signature(), T(std::forward<U>(value)), tick);
+		}
+
+		void Remove(Entity entity, uint16_t componentId);
+
+		// Destroys every component of the entity and frees its row
+		void RemoveEntity(uint32_t entityIndex);
+
+		inline void MarkChanged(uint32_t entityId, uint16_t componentId, uint32_t tick)
+		{
+			const EntityLocation& location = m_EntityLocations[entityId];
+			m_Archetypes[location.archetype]->ChangedTick(location.row, componentId) = tick;
+		}
+
+		inline void* GetComponent(uint32_t entityId, uint16_t componentId) const
+		{
+			assert(entityId < m_EntityLocations.size() && m_EntityLocations[entityId].archetype != INVALID_ARCHETYPE);
+			const EntityLocation& location = m_EntityLocations[entityId];
+			return m_Archetypes[location.archetype]->GetComponent(location.row, componentId);
+		}
+
+		// Compact(): the rows and locations follow the new entity indices, 'newEntityCount' of them.
+		// The rows don't move, the empty archetypes give their last chunk back
+		void RemapEntities(std::span<const Entity> newHandles, uint32_t newEntityCount);
+
+		// The chunks and the location table
+		size_t GetMemoryUsage() const;
+
+		inline const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return m_Archetypes; }
+		inline const std::vector<Signature>& GetSignatures() const { return m_Signatures; }
+	};
+}
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <vector>
+#include <memory_resource>
+#include <span>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include "EngineFramework/ECS/ECSTypes.h"
+#include "EngineFramework/ECS/PagedSparseArray.h"
+#include "EngineFramework/ECS/MemoryResources.h"
+
+namespace AlphaEngine
+{
+	class OwningGroup;
+	class WorldSnapshot;
+
+	// The part of a pool that doesn't care about T: which entity sits where, and when it changed.
+	// Living in the base lets the Views read the change ticks without knowing the type.
+	class IComponentPool
+	{
+	protected:
+		// Everything the pool allocates goes through here (counted, then forwarded to the resource the pool
+		// was created with). Declared first, the containers below are built with it
+		TrackingResource m_Resource;
+
+		// Maps Dense Index -> Entity handle (Needed for Swap-and-Pop)
+		// We keep the full handle (with generation) so Views hand out valid Entities
+		std::pmr::vector<Entity> m_DenseToEntity{ &m_Resource };
+
+		// The "Sparse" array: Maps Entity Index -> Index in m_Data
+		// -1 indicates "no component". Paged, so a pool with a few components of high
+		// entity indices doesn't pay for all the indices below them
+		PagedSparseArray m_EntityToIndex{ &m_Resource };
+
+		// Change versioning, same order as the dense array.
+		// Added -> the tick the component was added at
+		// Changed -> the last tick somebody wrote it through PatchComponent/MarkChanged (adding counts as a change)
+		std::pmr::vector<uint32_t> m_AddedTicks{ &m_Resource };
+		std::pmr::vector<uint32_t> m_ChangedTicks{ &m_Resource };
+
+		// The group that keeps this pool sorted (a pool can only be owned by one group)
+		OwningGroup* m_OwningGroup = nullptr;
+
+		// Snapshots load the dense arrays in bulk
+		friend class WorldSnapshot;
+
+		// After the dense arrays were loaded in bulk, point the sparse array back at them
+		void RebuildSparseFromDense()
+		{
+			m_EntityToIndex.Clear();
+			if (m_DenseToEntity.empty()) return;
+
+			uint32_t maxEntityId = 0;
+			for (const Entity& entity : m_DenseToEntity) {
+				maxEntityId = std::max(maxEntityId, entity.GetIndex());
+			}
+			m_EntityToIndex.Reserve(maxEntityId);
+
+			for (size_t i = 0; i < m_DenseToEntity.size(); ++i) {
+				m_EntityToIndex.Set(m_DenseToEntity[i].GetIndex(), static_cast<int32_t>(i));
+			}
+		}
+
+		// nullptr -> the default heap
+		explicit IComponentPool(std::pmr::memory_resource* upstream) : m_Resource(upstream) {}
+
+	public:
+		virtual ~IComponentPool() = default;
+
+		IComponentPool(const IComponentPool&) = delete;
+		IComponentPool& operator=(const IComponentPool&) = delete;
+		virtual void RemoveEntityFromPool(uint32_t entityIndex) = 0;
+
+		// Drops every component (the pool must not be owned by a group)
+		virtual void Reset() = 0;
+
+		// Swaps two dense slots (data, entity, ticks) and fixes the sparse array, used by the groups
+		virtual void SwapDense(uint32_t denseA, uint32_t denseB) = 0;
+
+		// Gives back the capacity the dense arrays kept from their peak
+		virtual void ShrinkToFit() = 0;
+
+		// ECSOrchestrator::Compact(): every entity becomes newHandles[its old index].
+		// The dense order (and with it any owning group) stays as is, only the sparse array is rebuilt
+		void RemapEntities(std::span<const Entity> newHandles)
+		{
+			for (Entity& entity : m_DenseToEntity) {
+				entity = newHandles[entity.GetIndex()];
+			}
+			RebuildSparseFromDense();
+		}
+
+		inline OwningGroup* GetOwningGroup() const { return m_OwningGroup; }
+		inline void SetOwningGroup(OwningGroup* group) { m_OwningGroup = group; }
+
+		inline uint32_t GetDenseIndex(uint32_t entityId) const { return static_cast<uint32_t>(m_EntityToIndex.GetUnchecked(entityId)); }
+
+		inline bool Contains(uint32_t entityId) const {
+			return m_EntityToIndex.Contains(entityId);
+		}
+
+		inline void MarkChanged(uint32_t entityId, uint32_t tick) {
+			assert(Contains(entityId));
+			m_ChangedTicks[m_EntityToIndex.GetUnchecked(entityId)] = tick;
+		}
+
+		inline uint32_t GetAddedTick(uint32_t entityId) const { return m_AddedTicks[m_EntityToIndex.GetUnchecked(entityId)]; }
+		inline uint32_t GetChangedTick(uint32_t entityId) const { return m_ChangedTicks[m_EntityToIndex.GetUnchecked(entityId)]; }
+
+		inline size_t GetSparseMemoryUsage() const { return m_EntityToIndex.GetMemoryUsage(); }
+		inline uint32_t GetSparsePageCount() const { return m_EntityToIndex.GetAllocatedPageCount(); }
+
+		inline uint32_t GetCount() const { return static_cast<uint32_t>(m_DenseToEntity.size()); }
+		// How many components fit before the dense arrays grow again
+		inline uint32_t GetCapacity() const { return static_cast<uint32_t>(m_DenseToEntity.capacity()); }
+
+		inline const std::pmr::vector<Entity>& GetDenseEntities() const {
+			return m_DenseToEntity;
+		}
+
+		// Bytes and allocations of this pool only (dense arrays, ticks, sparse pages)
+		inline const AllocationStats& GetAllocationStats() const { return m_Resource.GetStats(); }
+		inline std::pmr::memory_resource* GetUpstreamResource() const { return m_Resource.GetUpstream(); }
+	};
+
+	// <-------------------------- Owning Groups ----------------------------->
+	//
+	// Two sparse set pools fill their dense arrays in whatever order components were added, so walking
+	// Transform + Render means reading one of them randomly through the sparse array.
+	// An owning group keeps the first m_Size dense slots of every pool it owns for the entities that have
+	// ALL the owned components, in the SAME order:
+	//
+	// Transform pool | [e4] [e1] [e9] | [e2] [e7] ...
+	// Render pool    | [e4] [e1] [e9] | [e5] ...
+	//                 <-- m_Size = 3 -->
+	//
+	// Slot i of every owned pool is the same entity, so iterating the group is index i into each array.
+	// The pools call us whenever they gain or lose a component, and we swap the entity in/out of the front.
+	class OwningGroup
+	{
+	private:
+		Signature m_Signature;
+		std::vector<IComponentPool*> m_Pools;
+		uint32_t m_Size = 0;
+
+	public:
+		OwningGroup(const Signature& signature, std::vector<IComponentPool*> pools)
+			: m_Signature(signature), m_Pools(std::move(pools))
+		{
+			for (IComponentPool* pool : m_Pools) {
+				assert(pool->GetOwningGroup() == nullptr && "A pool can only be owned by one group!");
+				pool->SetOwningGroup(this);
+			}
+
+			// Pull everybody that already qualifies to the front. Any entity we swap backwards
+			// sits at an index we already visited (and rejected), so one pass is enough
+			const auto& entities = m_Pools[0]->GetDenseEntities();
+			for (size_t i = 0; i < entities.size(); ++i) {
+				OnComponentAdded(*m_Pools[0], entities[i].GetIndex());
+			}
+		}
+
+		~OwningGroup()
+		{
+			for (IComponentPool* pool : m_Pools) {
+				pool->SetOwningGroup(nullptr);
+			}
+		}
+
+		OwningGroup(const OwningGroup&) = delete;
+		OwningGroup& operator=(const OwningGroup&) = delete;
+
+		inline const Signature& GetSignature() const { return m_Signature; }
+		inline uint32_t GetSize() const { return m_Size; }
+
+		// 'pool' just got a component for the entity
+		void OnComponentAdded(const IComponentPool& pool, uint32_t entityId)
+		{
+			// Members are exactly the first m_Size slots, so anything past that isn't in the group yet
+			if (pool.GetDenseIndex(entityId) < m_Size) return;
+
+			for (IComponentPool* owned : m_Pools) {
+				if (!owned->Contains(entityId)) return;
+			}
+
+			for (IComponentPool* owned : m_Pools) {
+				owned->SwapDense(owned->GetDenseIndex(entityId), m_Size);
+			}
+			m_Size++;
+		}
+
+		// 'pool' is about to lose the component of the entity
+		void OnComponentRemoved(const IComponentPool& pool, uint32_t entityId)
+		{
+			if (pool.GetDenseIndex(entityId) >= m_Size) return;
+
+			// Swap it with the last member, the pool's swap and pop then only touches slots past the group
+			m_Size--;
+			for (IComponentPool* owned : m_Pools) {
+				owned->SwapDense(owned->GetDenseIndex(entityId), m_Size);
+			}
+		}
+	};
+
+	// Pool -> just a vector (contiguous data) of objects of type T
+	template <typename T>
+	class ComponentPool : public IComponentPool
+	{
+	private:
+
+		// Problem: 
+		// Index |   0			1			....			500				....			9999
+		// Data  |  [Health] [Health]		empty		 [Health]		   [empty]		  [Health]
+		// We do Dense - Sparse arrays because When our HealthSystem wants to update everyone, 
+		// the CPU has to "jump" from address 0 to address 500, then to address 999. This is a Cache Miss
+		// With Sparse set way:
+		//
+		// <------ The dense array (actualy comp data lives here) -------->
+		// Dense Index |	   0			1			2			
+		// Data		   |  [Health A] 	[Health B] 	[Health C]
+		//
+		// 
+		// <------ The Sparse array (where in the dense array to find that entity's data) -------->
+		// Entity ID	 |	   0			....			500				....			999			
+		// Value		 |     0			-1				1				-1				2
+
+		// The "Dense" array: Tightly packed component data for CPU cache speed
+		std::pmr::vector<T> m_Data{ &m_Resource };
+
+	public:
+		// 'upstream' is where the memory really comes from (a LargePageArena, a ChurnPoolResource, ...), nullptr -> the heap
+		explicit ComponentPool(std::pmr::memory_resource* upstream = nullptr, uint32_t size = 1000)
+			: IComponentPool(upstream)
+		{
+			m_Data.reserve(size);
+			m_DenseToEntity.reserve(size);
+			m_AddedTicks.reserve(size);
+			m_ChangedTicks.reserve(size);
+		}
+		virtual ~ComponentPool() = default;
+
+		bool isEmpty() const { return m_Data.empty(); }
+		uint32_t GetSize() const { return static_cast<uint32_t>(m_Data.size()); }
+		void Clear() { m_Data.clear(); }
+
+		void AddComp(Entity entity, T Object, uint32_t tick)
+		{
+			const uint32_t entityId = entity.GetIndex();
+
+			// Already has one? Just replace the value, pushing again would leave a second dense slot behind
+			const int32_t existing = m_EntityToIndex.Get(entityId);
+			if (existing != PagedSparseArray::EMPTY) {
+				m_Data[existing] = std::move(Object);
+				m_ChangedTicks[existing] = tick;
+				return;
+			}
+
+			// Map entity to the end of the dense array (allocates the page if needed)
+			m_EntityToIndex.Set(entityId, static_cast<int32_t>(m_Data.size()));
+
+			// Push data to the end
+			m_Data.push_back(std::move(Object));
+			m_DenseToEntity.push_back(entity);
+			m_AddedTicks.push_back(tick);
+			m_ChangedTicks.push_back(tick);
+
+			if (m_OwningGroup) m_OwningGroup->OnComponentAdded(*this, entityId);
+		}
+
+		// Same as calling AddComp for every entity, but the sparse page table grows once
+		// and the dense arrays reserve once for the whole batch (objects are moved from)
+		void AddComps(std::span<const Entity> entities, std::span<T> objects, uint32_t tick)
+		{
+			assert(entities.size() == objects.size());
+
+			uint32_t maxEntityId = 0;
+			for (const Entity& entity : entities) {
+				maxEntityId = std::max(maxEntityId, entity.GetIndex());
+			}
+			if (!entities.empty()) {
+				m_EntityToIndex.Reserve(maxEntityId);
+			}
+
+			// Keep growing geometrically, many small batches would otherwise reallocate every time
+			const size_t needed = m_Data.size() + entities.size();
+			if (needed > m_Data.capacity()) {
+				const size_t newCapacity = std::max(needed, m_Data.capacity() * 2);
+				m_Data.reserve(newCapacity);
+				m_DenseToEntity.reserve(newCapacity);
+				m_AddedTicks.reserve(newCapacity);
+				m_ChangedTicks.reserve(newCapacity);
+			}
+
+			for (size_t i = 0; i < entities.size(); ++i) {
+				const uint32_t entityId = entities[i].GetIndex();
+
+				const int32_t existing = m_EntityToIndex.Get(entityId);
+				if (existing != PagedSparseArray::EMPTY) {
+					m_Data[existing] = std::move(objects[i]);
+					m_ChangedTicks[existing] = tick;
+					continue;
+				}
+
+				m_EntityToIndex.Set(entityId, static_cast<int32_t>(m_Data.size()));
+				m_Data.push_back(std::move(objects[i]));
+				m_DenseToEntity.push_back(entities[i]);
+				m_AddedTicks.push_back(tick);
+				m_ChangedTicks.push_back(tick);
+
+				if (m_OwningGroup) m_OwningGroup->OnComponentAdded(*this, entityId);
+			}
+		}
+
+		// Every entity gets a copy of the same value (prefab instantiation), grows like AddComps
+		void AddCopies(std::span<const Entity> entities, const T& value, uint32_t tick)
+		{
+			uint32_t maxEntityId = 0;
+			for (const Entity& entity : entities) {
+				maxEntityId = std::max(maxEntityId, entity.GetIndex());
+			}
+			if (!entities.empty()) {
+				m_EntityToIndex.Reserve(maxEntityId);
+			}
+
+			const size_t needed = m_Data.size() + entities.size();
+			if (needed > m_Data.capacity()) {
+				const size_t newCapacity = std::max(needed, m_Data.capacity() * 2);
+				m_Data.reserve(newCapacity);
+				m_DenseToEntity.reserve(newCapacity);
+				m_AddedTicks.reserve(newCapacity);
+				m_ChangedTicks.reserve(newCapacity);
+			}
+
+			for (const Entity& entity : entities) {
+				const uint32_t entityId = entity.GetIndex();
+
+				const int32_t existing = m_EntityToIndex.Get(entityId);
+				if (existing != PagedSparseArray::EMPTY) {
+					m_Data[existing] = value;
+					m_ChangedTicks[existing] = tick;
+					continue;
+				}
+
+				m_EntityToIndex.Set(entityId, static_cast<int32_t>(m_Data.size()));
+				m_Data.push_back(value);
+				m_DenseToEntity.push_back(entity);
+				m_AddedTicks.push_back(tick);
+				m_ChangedTicks.push_back(tick);
+
+				if (m_OwningGroup) m_OwningGroup->OnComponentAdded(*this, entityId);
+			}
+		}
+
+		void RemoveComp(uint32_t entityId)
+		{
+			// Leave the group first, this can move the entity inside the dense array
+			if (m_OwningGroup) m_OwningGroup->OnComponentRemoved(*this, entityId);
+
+			int indexToRemove = m_EntityToIndex.GetUnchecked(entityId);
+			int lastIndex = static_cast<int>(m_Data.size()) - 1;
+
+			// Move last element to the hole
+			m_Data[indexToRemove] = std::move(m_Data[lastIndex]);
+
+			// Update mapings
+			Entity entityOfLastElement = m_DenseToEntity[lastIndex];
+			m_EntityToIndex.Set(entityOfLastElement.GetIndex(), indexToRemove);
+			m_DenseToEntity[indexToRemove] = entityOfLastElement;
+			m_AddedTicks[indexToRemove] = m_AddedTicks[lastIndex];
+			m_ChangedTicks[indexToRemove] = m_ChangedTicks[lastIndex];
+
+			// Cleanup
+			m_Data.pop_back();
+			m_DenseToEntity.pop_back();
+			m_AddedTicks.pop_back();
+			m_ChangedTicks.pop_back();
+			// Can free the page if this was the last entity in it
+			m_EntityToIndex.Remove(entityId);
+		}
+
+		void Reset() override
+		{
+			assert(m_OwningGroup == nullptr && "Destroy the group before resetting its pools!");
+			m_Data.clear();
+			m_DenseToEntity.clear();
+			m_AddedTicks.clear();
+			m_ChangedTicks.clear();
+			m_EntityToIndex.Clear();
+		}
+
+		void RemoveEntityFromPool(uint32_t entityId) override {
+			// Check if the entity is within range of our sparse array
+			// Check if the value is not -1 (meaning it actually has a component)
+			if (m_EntityToIndex.Contains(entityId)) {
+				RemoveComp(entityId); // This calls your Swap-and-Pop logic
+			}
+		}
+		T& Get(uint32_t entityId) {
+			assert(m_EntityToIndex.Contains(entityId));
+
+
+			int index = m_EntityToIndex.GetUnchecked(entityId);
+
+
+			return m_Data[index];
+		}
+
+		uint32_t GetCount() const {
+			return static_cast<uint32_t>(m_Data.size());
+		}
+
+		void ShrinkToFit() override
+		{
+			m_Data.shrink_to_fit();
+			m_DenseToEntity.shrink_to_fit();
+			m_AddedTicks.shrink_to_fit();
+			m_ChangedTicks.shrink_to_fit();
+		}
+
+		void SwapDense(uint32_t denseA, uint32_t denseB) override
+		{
+			if (denseA == denseB) return;
+
+			std::swap(m_Data[denseA], m_Data[denseB]);
+			std::swap(m_DenseToEntity[denseA], m_DenseToEntity[denseB]);
+			std::swap(m_AddedTicks[denseA], m_AddedTicks[denseB]);
+			std::swap(m_ChangedTicks[denseA], m_ChangedTicks[denseB]);
+
+			m_EntityToIndex.Set(m_DenseToEntity[denseA].GetIndex(), static_cast<int32_t>(denseA));
+			m_EntityToIndex.Set(m_DenseToEntity[denseB].GetIndex(), static_cast<int32_t>(denseB));
+		}
+
+		// <--- Fast paths used by the Views (no asserts, no pool lookups) --->
+
+		inline T& GetUnchecked(uint32_t entityId) {
+			return m_Data[m_EntityToIndex.GetUnchecked(entityId)];
+		}
+
+		inline T& GetByDenseIndex(size_t denseIndex) {
+			return m_Data[denseIndex];
+		}
+
+		std::pmr::vector<T>& GetAllData() {
+			return m_Data;
+		}
+
+		const std::pmr::vector<T>& GetAllData() const {
+			return m_Data;
+		}
+	};
+}
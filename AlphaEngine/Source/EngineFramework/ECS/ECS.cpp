@@ -6,20 +6,22 @@
 namespace AlphaEngine
 {
 	uint16_t IComponent::nextId = 0;
+	uint16_t ISystemType::nextId = 0;
 
-	uint16_t Entity::GetId() const
+	uint32_t Entity::GetId() const
 	{
 		return m_id;
 	}
 
 	void System::AddEntityToSystem(Entity entity)
 	{
-		uint16_t id = entity.GetId();
-		if (id >= m_EntityToIndex.size()) m_EntityToIndex.resize(id + 500, -1);
+		uint32_t id = entity.GetIndex();
 
 		// Map the ID to the current end of the list
-		m_EntityToIndex[id] = static_cast<int>(m_Entities.size());
+		m_EntityToIndex.Set(id, static_cast<int32_t>(m_Entities.size()));
 		m_Entities.push_back(entity);
+
+		OnEntityAdded(entity);
 	}
 
 	// remove if It is an O(n) operation. If we have 5000 entities in a system,
@@ -28,58 +30,159 @@ namespace AlphaEngine
 	// We need to use Swap and Pop -> Use a helper map to know exactly where the entity is O(1) for lookup
 	void System::RemoveEntityFromSystem(Entity entity)
 	{
-		uint16_t id = entity.GetId();
-		int indexToRemove = m_EntityToIndex[id];
+		uint32_t id = entity.GetIndex();
+		int indexToRemove = m_EntityToIndex.Get(id);
 		if (indexToRemove == -1) return;
 
 		Entity lastEntity = m_Entities.back();
 		m_Entities[indexToRemove] = lastEntity;
 		// Instant update
 
-		m_EntityToIndex[lastEntity.GetId()] = indexToRemove; 
+		m_EntityToIndex.Set(lastEntity.GetIndex(), indexToRemove);
 
 		m_Entities.pop_back();
-		m_EntityToIndex[id] = -1;
+		m_EntityToIndex.Remove(id);
+
+		OnEntityRemoved(entity);
+	}
+
+	void System::ReserveEntityIndex(uint32_t maxEntityIndex)
+	{
+		m_EntityToIndex.Reserve(maxEntityIndex);
 	}
 
 	bool System::HasEntity(Entity entity) const
 	{
-		uint16_t id = entity.GetId();
+		// Check if the value is NOT -1 (Since we use -1 for "not in system logic")
+		return m_EntityToIndex.Contains(entity.GetIndex());
+	}
 
-		if (id >= m_EntityToIndex.size()) {
-			return false;
+	void System::ClearEntities()
+	{
+		for (const Entity& entity : m_Entities) {
+			OnEntityRemoved(entity);
 		}
+		m_Entities.clear();
+		m_EntityToIndex.Clear();
+	}
 
-		// Check if the value is NOT -1 (Since we use -1 for "not in system logic")
-		return m_EntityToIndex[id] != -1;
+	void System::RemapEntities(std::span<const Entity> newHandles)
+	{
+		uint32_t maxEntityId = 0;
+		for (Entity& entity : m_Entities) {
+			entity = newHandles[entity.GetIndex()];
+			maxEntityId = std::max(maxEntityId, entity.GetIndex());
+		}
+
+		// Built fresh, so the pages only cover the new (smaller) index range
+		PagedSparseArray entityToIndex(m_EntityToIndex.GetMemoryResource());
+		if (!m_Entities.empty()) entityToIndex.Reserve(maxEntityId);
+		for (size_t i = 0; i < m_Entities.size(); ++i) {
+			entityToIndex.Set(m_Entities[i].GetIndex(), static_cast<int32_t>(i));
+		}
+		m_EntityToIndex = std::move(entityToIndex);
+		m_Entities.shrink_to_fit();
+	}
+
+	size_t System::GetMemoryUsage() const
+	{
+		return m_Entities.capacity() * sizeof(Entity) + m_EntityToIndex.GetMemoryUsage();
 	}
 
-	const std::vector<Entity>& System::GetSystemEntities() const
+	const std::pmr::vector<Entity>& System::GetSystemEntities() const
 	{
 		//Logger::Log("System tracking entities count: " + std::to_string(m_Entities.size()) + " for a specific system: ");
 
 		return m_Entities;
 	}
 
-	const Signature& System::GetComponentSignature()
+	void System::SetMemoryResource(std::pmr::memory_resource* resource)
+	{
+		assert(m_Entities.empty() && "Set the memory resource before the system gets entities!");
+
+		// A pmr vector keeps the allocator it was built with, so build it again
+		std::destroy_at(&m_Entities);
+		std::construct_at(&m_Entities, resource);
+		m_EntityToIndex = PagedSparseArray(resource);
+	}
+
+	const Signature& System::GetComponentSignature() const
 	{
 		return m_ComponentSignature;
 	}
 
+	void System::SetTickPolicy(const SystemTickPolicy& policy)
+	{
+		assert((policy.mode != SystemTickMode::FixedRate || policy.hz > 0.0f) && "A FixedRate system needs a rate!");
+		assert((policy.mode != SystemTickMode::TimeSliced || policy.slices > 0) && "A TimeSliced system needs at least one slice!");
+
+		m_TickPolicy = policy;
+		m_TickAccumulator = 0.0f;
+		m_SliceCursor = 0;
+		// Only EveryFrame runs without BeginFrame() saying so
+		m_TickDue = policy.mode == SystemTickMode::EveryFrame;
+	}
+
+	void System::AdvanceTick(float frameDeltaTime)
+	{
+		m_TimeSinceTick += frameDeltaTime;
+
+		switch (m_TickPolicy.mode) {
+		case SystemTickMode::EveryFrame:
+		case SystemTickMode::TimeSliced:
+			m_TickDue = true;
+			break;
+
+		case SystemTickMode::FixedRate: {
+			const float period = 1.0f / m_TickPolicy.hz;
+			m_TickAccumulator += frameDeltaTime;
+			m_TickDue = m_TickAccumulator >= period;
+			if (m_TickDue) {
+				// One run per frame at most, and a long frame doesn't queue up catch-up runs either:
+				// these systems are latency tolerant and running them back to back is the spike we are avoiding
+				m_TickAccumulator -= period;
+				if (m_TickAccumulator >= period) m_TickAccumulator = 0.0f;
+			}
+			break;
+		}
+
+		case SystemTickMode::Manual:
+			m_TickDue = m_TickRequested;
+			m_TickRequested = false;
+			break;
+		}
+
+		if (m_TickDue) {
+			m_TickDeltaTime = m_TimeSinceTick;
+			m_TimeSinceTick = 0.0f;
+		}
+	}
+
+	void ECSOrchestrator::BeginFrame(float deltaTime)
+	{
+		for (System* system : m_SystemOrder) {
+			system->AdvanceTick(deltaTime);
+		}
+	}
+
 	Entity ECSOrchestrator::CreateEntity()
 	{
 
-		uint16_t entityId;
+		uint32_t entityId;
 
 		if (m_FreeIDs.empty())
 		{
 			// If there are no free ids waiting to be used
 			entityId = m_NumEntities++;
+			assert(entityId < Entity::MaxEntities && "Ran out of entity indices!");
 
 			// Make sure the entityComponentSignatures vector can accomadate the new entity
 			if (entityId >= m_EntityComponentSignature.size())
 			{
 				m_EntityComponentSignature.resize(entityId + 1);
+				m_EntityGenerations.resize(entityId + 1, m_FreshGeneration);
+				m_PendingAdd.resize(entityId + 1, 0);
+				m_SystemSignatures.resize(entityId + 1);
 			}
 		}
 		else 
@@ -91,76 +194,538 @@ namespace AlphaEngine
 		}
 	
 
-		Entity entity(entityId);
+		// The generation was already bumped when the slot was freed
+		Entity entity(entityId, m_EntityGenerations[entityId]);
 		m_EntitiesToBeAdded.push_back(entity);
+		m_PendingAdd[entityId] = 1;
 
 		//AlphaEngine::Logger::Log("Entity Created with id = " + std::to_string(entityId));
 
 		return entity;
 	}
 
+	std::vector<Entity> ECSOrchestrator::CreateEntities(uint32_t count)
+	{
+		std::vector<Entity> entities;
+		entities.reserve(count);
+
+		// Recycle the free ids first, same as CreateEntity would
+		const uint32_t recycledCount = std::min(count, static_cast<uint32_t>(m_FreeIDs.size()));
+		for (uint32_t i = 0; i < recycledCount; ++i) {
+			const uint32_t entityId = m_FreeIDs.back();
+			m_FreeIDs.pop_back();
+			entities.emplace_back(entityId, m_EntityGenerations[entityId]);
+		}
+
+		// Then grow everything once for the fresh ones
+		const uint32_t freshCount = count - recycledCount;
+		const uint32_t firstFreshId = m_NumEntities.fetch_add(freshCount);
+		const uint32_t newNumEntities = firstFreshId + freshCount;
+		assert(newNumEntities <= Entity::MaxEntities && "Ran out of entity indices!");
+
+		if (newNumEntities > m_EntityComponentSignature.size()) {
+			m_EntityComponentSignature.resize(newNumEntities);
+			m_EntityGenerations.resize(newNumEntities, m_FreshGeneration);
+			m_PendingAdd.resize(newNumEntities, 0);
+			m_SystemSignatures.resize(newNumEntities);
+		}
+
+		for (uint32_t entityId = firstFreshId; entityId < newNumEntities; ++entityId) {
+			entities.emplace_back(entityId, m_EntityGenerations[entityId]);
+		}
+
+		for (const Entity& entity : entities) {
+			m_PendingAdd[entity.GetIndex()] = 1;
+		}
+		m_EntitiesToBeAdded.insert(m_EntitiesToBeAdded.end(), entities.begin(), entities.end());
+
+		return entities;
+	}
+
+	std::vector<Entity> ECSOrchestrator::Instantiate(const Prefab& prefab, uint32_t count)
+	{
+		std::vector<Entity> entities = CreateEntities(count);
+		ClonePrefab(prefab, entities, prefab.GetSignature(), -1, GetChangeTick());
+		FinishInstantiate(entities, prefab.GetSignature());
+		return entities;
+	}
+
+	void ECSOrchestrator::ClonePrefab(const Prefab& prefab, std::span<const Entity> entities, const Signature& signature, int32_t skipComponentId, uint32_t tick)
+	{
+		// Straight into the final archetype, the components are constructed in place below
+		if (m_StorageBackend == ECSStorageBackend::Archetype) {
+			m_ArchetypeStorage.PushNewEntities(entities, signature & ~IComponent::GetTagSignature());
+		}
+
+		for (const Prefab::Entry& entry : prefab.m_Entries) {
+			if (entry.componentId == skipComponentId) continue;
+			entry.clone(*this, entities, entry.value.get(), tick);
+		}
+	}
+
+	void ECSOrchestrator::FinishInstantiate(std::span<const Entity> entities, const Signature& signature)
+	{
+		// Fresh entities: nothing to merge, and they are pending so no refresh either
+		for (const Entity& entity : entities) {
+			m_EntityComponentSignature[entity.GetIndex()] = signature;
+		}
+
+		bool hasHooks = false;
+		ForEachComponent(signature, [&](uint16_t componentId) { hasHooks |= !m_ConstructHooks[componentId].empty(); });
+		if (!hasHooks) return;
+
+		for (const Entity& entity : entities) {
+			ForEachComponent(signature, [&](uint16_t componentId) { FireHooks(m_ConstructHooks[componentId], entity); });
+		}
+	}
+
+	Entity ECSOrchestrator::ReserveEntity()
+	{
+		const uint32_t entityId = m_NumEntities.fetch_add(1, std::memory_order_relaxed);
+		assert(entityId < Entity::MaxEntities && "Ran out of entity indices!");
+
+		// A slot that was never used (or dropped by Compact()) starts at the fresh generation
+		return Entity(entityId, m_FreshGeneration);
+	}
+
+	EntityCommandBuffer& ECSOrchestrator::GetCommandBuffer()
+	{
+		thread_local uint32_t t_OwnerId = 0;
+		thread_local EntityCommandBuffer* t_Buffer = nullptr;
+
+		if (t_OwnerId != m_InstanceId) {
+			std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
+			// The cache only remembers the last orchestrator, this thread may already have a buffer here
+			EntityCommandBuffer*& buffer = m_CommandBufferByThread[std::this_thread::get_id()];
+			if (!buffer) {
+				m_CommandBuffers.push_back(std::make_unique<EntityCommandBuffer>(*this));
+				buffer = m_CommandBuffers.back().get();
+			}
+			t_Buffer = buffer;
+			t_OwnerId = m_InstanceId;
+		}
+		return *t_Buffer;
+	}
+
+	void ECSOrchestrator::PlaybackCommandBuffers()
+	{
+		size_t commandCount = 0;
+		for (const auto& buffer : m_CommandBuffers) {
+			commandCount += buffer->GetCommandCount();
+		}
+		if (commandCount == 0) return;
+
+		// Reserved ids can be past the end of our arrays
+		const uint32_t numEntities = m_NumEntities.load();
+		if (numEntities > m_EntityComponentSignature.size()) {
+			m_EntityComponentSignature.resize(numEntities);
+			m_EntityGenerations.resize(numEntities, m_FreshGeneration);
+			m_PendingAdd.resize(numEntities, 0);
+			m_SystemSignatures.resize(numEntities);
+		}
+
+		struct SortedCommand
+		{
+			uint32_t entityIndex;
+			uint32_t buffer;
+			uint32_t sequence;
+			const EntityCommandBuffer::Command* command;
+		};
+
+		// Creates first, so every other command sees its entity no matter how it sorts
+		std::vector<SortedCommand> commands;
+		commands.reserve(commandCount);
+		for (uint32_t bufferIndex = 0; bufferIndex < m_CommandBuffers.size(); ++bufferIndex) {
+			for (const auto& command : m_CommandBuffers[bufferIndex]->GetCommands()) {
+				if (command.type == EntityCommandBuffer::CommandType::Create) {
+					m_EntitiesToBeAdded.push_back(command.entity);
+					m_PendingAdd[command.entity.GetIndex()] = 1;
+				}
+				else {
+					commands.push_back({ command.entity.GetIndex(), bufferIndex, command.sequence, &command });
+				}
+			}
+		}
+
+		// The threads record in whatever order they get scheduled, sorting by entity makes the result
+		// (pool order, refresh order) the same every run. Commands on the same entity keep their recorded order
+		std::sort(commands.begin(), commands.end(), [](const SortedCommand& a, const SortedCommand& b) {
+			if (a.entityIndex != b.entityIndex) return a.entityIndex < b.entityIndex;
+			if (a.buffer != b.buffer) return a.buffer < b.buffer;
+			return a.sequence < b.sequence;
+			});
+
+		for (const SortedCommand& sorted : commands) {
+			const EntityCommandBuffer::Command& command = *sorted.command;
+
+			// The entity could have been destroyed since the command was recorded
+			if (!IsAlive(command.entity)) continue;
+
+			switch (command.type) {
+			case EntityCommandBuffer::CommandType::AddComponent:
+			case EntityCommandBuffer::CommandType::RemoveComponent:
+				command.apply(*this, command.entity, command.payload);
+				break;
+			case EntityCommandBuffer::CommandType::Destroy:
+				DestroyEntity(command.entity);
+				break;
+			default:
+				break;
+			}
+		}
+
+		for (auto& buffer : m_CommandBuffers) {
+			buffer->Clear();
+		}
+	}
+
 	void ECSOrchestrator::DestroyEntity(Entity entity)
 	{
 		m_EntitiesToBeDestroyed.push_back(entity);
 	}
 
+	void ECSOrchestrator::IndexSystem(System* system)
+	{
+		const Signature& signature = system->GetComponentSignature();
+		if (signature.none()) {
+			m_UnfilteredSystems.push_back(system);
+			return;
+		}
+
+		ForEachComponent(signature, [&](uint16_t componentId) { m_SystemsWithComponent[componentId].push_back(system); });
+
+		bool anchored = false;
+		ForEachComponent(signature, [&](uint16_t componentId) {
+			if (!anchored) {
+				m_SystemsAnchoredAt[componentId].push_back(system);
+				m_AnchoredSignatures[componentId].push_back(signature);
+			}
+			anchored = true;
+			});
+	}
+
+	void ECSOrchestrator::UnindexSystem(System* system)
+	{
+		auto erase = [system](std::vector<System*>& systems) {
+			systems.erase(std::remove(systems.begin(), systems.end(), system), systems.end());
+			};
+
+		erase(m_UnfilteredSystems);
+		for (auto& systems : m_SystemsWithComponent) erase(systems);
+
+		// The anchored signatures have to stay in step with their systems
+		for (uint16_t componentId = 0; componentId < MAX_COMPONENTS; ++componentId) {
+			auto& systems = m_SystemsAnchoredAt[componentId];
+			auto it = std::find(systems.begin(), systems.end(), system);
+			if (it == systems.end()) continue;
+
+			m_AnchoredSignatures[componentId].erase(m_AnchoredSignatures[componentId].begin() + (it - systems.begin()));
+			systems.erase(it);
+		}
+	}
+
 	void ECSOrchestrator::AddEntityToSystems(Entity entity)
 	{
-		const auto entityId = entity.GetId();
+		const auto entityId = entity.GetIndex();
 		const auto& entityCompSignature = m_EntityComponentSignature[entityId];
 
-		for (auto& system : m_Systems)
-		{
-			const auto& systemCompSignature = system.second->GetComponentSignature();
+		// Only the systems anchored on one of our components can match
+		ForEachComponent(entityCompSignature, [&](uint16_t componentId) {
+			const auto& systems = m_SystemsAnchoredAt[componentId];
+			const auto& systemSignatures = m_AnchoredSignatures[componentId];
+			ForEachSignatureContainedIn(systemSignatures.data(), systemSignatures.size(), entityCompSignature, [&](size_t index) {
+				systems[index]->AddEntityToSystem(entity);
+				});
+			});
+
+		for (System* system : m_UnfilteredSystems) {
+			system->AddEntityToSystem(entity);
+		}
 
-			bool isInterested = (entityCompSignature & systemCompSignature) == systemCompSignature;
+		m_SystemSignatures[entityId] = entityCompSignature;
+	}
 
-			if (isInterested)
-			{
+	void ECSOrchestrator::AddEntitiesToSystems(std::span<const Entity> entities)
+	{
+		if (entities.empty()) return;
 
-				system.second->AddEntityToSystem(entity);
-			}
+		uint32_t maxEntityId = 0;
+		for (const Entity& entity : entities) {
+			maxEntityId = std::max(maxEntityId, entity.GetIndex());
+		}
+
+		// Each system grows its lookup once for the whole batch
+		for (System* system : m_SystemOrder) {
+			system->ReserveEntityIndex(maxEntityId);
+		}
+
+		for (const Entity& entity : entities) {
+			AddEntityToSystems(entity);
 		}
 	}
 
 	void ECSOrchestrator::RemoveEntityFromSystems(Entity entity)
 	{
-		for (auto& system : m_Systems)
-		{
-			system.second->RemoveEntityFromSystem(entity);
+		const auto entityId = entity.GetIndex();
+
+		// The systems can only have the entity if it matched them with the last signature they saw
+		ForEachComponent(m_SystemSignatures[entityId], [&](uint16_t componentId) {
+			for (System* system : m_SystemsAnchoredAt[componentId]) {
+				system->RemoveEntityFromSystem(entity);
+			}
+			});
+
+		for (System* system : m_UnfilteredSystems) {
+			system->RemoveEntityFromSystem(entity);
 		}
+
+		m_SystemSignatures[entityId].reset();
 	}
 
 	// We do that Because we need to know in runtime and not only once the entity is created,
 	// if this entity signature just changed. So refresh it if not already in the system.
+	// Only the systems that require one of the components that changed since the last refresh can flip
 	void ECSOrchestrator::RefreshEntity(Entity entity)
 	{
-		const auto entityId = entity.GetId();
+		const auto entityId = entity.GetIndex();
 		const auto& entityCompSignature = m_EntityComponentSignature[entityId];
+		const Signature changedSignature = entityCompSignature ^ m_SystemSignatures[entityId];
 
-		for (auto& pair : m_Systems) {
-			auto& system = pair.second;
+		// A system that requires several of the changed components is visited more than once,
+		// that's fine since the second visit finds it already up to date
+		ForEachComponent(changedSignature, [&](uint16_t componentId) {
+			for (System* system : m_SystemsWithComponent[componentId]) {
+				const auto& systemSignature = system->GetComponentSignature();
 
-			const auto& systemSignature = system->GetComponentSignature();
+				bool isInterested = (entityCompSignature & systemSignature) == systemSignature;
 
-			bool isInterested = (entityCompSignature & systemSignature) == systemSignature;
+				// Already have the entity?
+				bool alreadyInSystem = system->HasEntity(entity);
 
-			// Already have the entity?
-			bool alreadyInSystem = system->HasEntity(entity);
-
-			if (isInterested && !alreadyInSystem) {
-				system->AddEntityToSystem(entity);
+				if (isInterested && !alreadyInSystem) {
+					system->AddEntityToSystem(entity);
+				}
+				else if (!isInterested && alreadyInSystem) {
+					system->RemoveEntityFromSystem(entity);
+				}
 			}
-			else if (!isInterested && alreadyInSystem) {
-				system->RemoveEntityFromSystem(entity);
+			});
+
+		m_SystemSignatures[entityId] = entityCompSignature;
+	}
+
+	bool ECSOrchestrator::CanCompact() const
+	{
+		for (const auto& buffer : m_CommandBuffers) {
+			if (buffer->GetCommandCount() > 0) return false;
+		}
+		return m_EntitiesToBeAdded.empty() && m_EntitiesToBeDestroyed.empty() && m_EntitiesToRefresh.empty();
+	}
+
+	CompactStats ECSOrchestrator::Compact()
+	{
+		CompactStats stats;
+		if (!CanCompact()) {
+			Logger::Err("Compact: entities or commands are still waiting for UpdateEntitiesLifeTime, ignored");
+			return stats;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		const uint32_t oldCount = m_NumEntities.load();
+		const uint32_t liveCount = oldCount - static_cast<uint32_t>(m_FreeIDs.size());
+		stats.indicesBefore = oldCount;
+		stats.bytesBefore = GetMemoryUsage();
+
+		std::vector<uint8_t> isFree(oldCount, 0);
+		for (const uint32_t entityId : m_FreeIDs) {
+			isFree[entityId] = 1;
+		}
+
+		// <--- New indices --->
+
+		EntityRemap remap;
+		remap.m_OldHandles.assign(oldCount, Entity());
+		remap.m_NewHandles.assign(oldCount, Entity());
+
+		std::vector<Signature> signatures;
+		std::vector<Signature> systemSignatures;
+		std::vector<uint16_t> generations;
+		signatures.reserve(liveCount);
+		systemSignatures.reserve(liveCount);
+		generations.reserve(liveCount);
+
+		for (uint32_t oldIndex = 0; oldIndex < oldCount; ++oldIndex) {
+			if (isFree[oldIndex]) continue;
+			const uint32_t newIndex = static_cast<uint32_t>(generations.size());
+
+			// Staying put keeps the handle. Moving into a slot takes the slot's next generation, so the handles
+			// of whoever had it before go stale: a free slot's generation was already bumped when it was freed,
+			// a live one (its entity moved further down) still has to be bumped
+			uint16_t generation = m_EntityGenerations[oldIndex];
+			if (newIndex != oldIndex) {
+				generation = isFree[newIndex] ? m_EntityGenerations[newIndex] : (m_EntityGenerations[newIndex] + 1) & Entity::GenerationMask;
 			}
+
+			remap.m_OldHandles[oldIndex] = Entity(oldIndex, m_EntityGenerations[oldIndex]);
+			remap.m_NewHandles[oldIndex] = Entity(newIndex, generation);
+			signatures.push_back(m_EntityComponentSignature[oldIndex]);
+			systemSignatures.push_back(m_SystemSignatures[oldIndex]);
+			generations.push_back(generation);
+		}
+
+		// The slots from liveCount on are dropped, when they are handed out again their old handles must not match
+		for (uint32_t index = liveCount; index < oldCount; ++index) {
+			const uint16_t next = (m_EntityGenerations[index] + 1) & Entity::GenerationMask;
+			m_FreshGeneration = std::max(m_FreshGeneration, next);
+		}
+
+		// <--- Entity bookkeeping, exactly as big as the live entities --->
+
+		m_EntityComponentSignature = std::move(signatures);
+		m_SystemSignatures = std::move(systemSignatures);
+		m_EntityGenerations = std::move(generations);
+		m_PendingAdd.assign(liveCount, 0);
+		m_PendingAdd.shrink_to_fit();
+		m_FreeIDs.clear();
+		m_FreeIDs.shrink_to_fit();
+		m_NumEntities.store(liveCount);
+
+		// A burst can have grown the queues way past their usual size
+		auto shrinkQueue = [](auto& queue) {
+			if (queue.capacity() <= 1000) return;
+			queue.shrink_to_fit();
+			queue.reserve(1000);
+			};
+		shrinkQueue(m_EntitiesToBeAdded);
+		shrinkQueue(m_EntitiesToBeDestroyed);
+		shrinkQueue(m_EntitiesToRefresh);
+
+		// <--- Storage and systems --->
+
+		const std::span<const Entity> newHandles = remap.GetNewHandles();
+		if (m_StorageBackend == ECSStorageBackend::Archetype) {
+			m_ArchetypeStorage.RemapEntities(newHandles, liveCount);
 		}
+		for (auto& pool : m_ComponentPools) {
+			if (!pool) continue;
+			pool->RemapEntities(newHandles);
+			pool->ShrinkToFit();
+		}
+		for (System* system : m_SystemOrder) {
+			system->RemapEntities(newHandles);
+		}
+		m_PrimaryCamera = remap(m_PrimaryCamera);
 
+		// The world is consistent again, now the handles kept outside of it
+		for (System* system : m_SystemOrder) {
+			system->OnEntitiesRemapped(*this, remap);
+		}
+		for (const auto& hook : m_CompactHooks) {
+			hook(*this, remap);
+		}
+
+		stats.liveEntities = liveCount;
+		stats.indicesAfter = liveCount;
+		stats.bytesAfter = GetMemoryUsage();
+		stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		Logger::Log("Compact: " + std::to_string(liveCount) + " live entities, " + std::to_string(oldCount) + " -> " + std::to_string(liveCount) +
+			" ids, " + std::to_string(stats.GetBytesReclaimed() / 1024) + " KB reclaimed in " + std::to_string(stats.milliseconds) + "ms");
+		return stats;
+	}
+
+	size_t ECSOrchestrator::GetEntityMemoryUsage() const
+	{
+		return (m_EntityComponentSignature.capacity() + m_SystemSignatures.capacity()) * sizeof(Signature)
+			+ m_EntityGenerations.capacity() * sizeof(uint16_t)
+			+ m_PendingAdd.capacity() * sizeof(uint8_t)
+			+ m_FreeIDs.capacity() * sizeof(uint32_t)
+			+ (m_EntitiesToBeAdded.capacity() + m_EntitiesToBeDestroyed.capacity() + m_EntitiesToRefresh.capacity()) * sizeof(Entity);
+	}
+
+	size_t ECSOrchestrator::GetMemoryUsage() const
+	{
+		size_t bytes = GetEntityMemoryUsage();
+		for (const auto& pool : m_ComponentPools) {
+			if (pool) bytes += pool->GetAllocationStats().bytesInUse;
+		}
+		for (const System* system : m_SystemOrder) {
+			bytes += system->GetMemoryUsage();
+		}
+		if (m_StorageBackend == ECSStorageBackend::Archetype) {
+			bytes += m_ArchetypeStorage.GetMemoryUsage();
+		}
+		return bytes;
+	}
+
+	void ECSOrchestrator::GetStats(ECSStats& stats) const
+	{
+		stats.backend = m_StorageBackend == ECSStorageBackend::Archetype ? "archetype" : "sparse_set";
+
+		// Ids reserved by the command buffers only get a slot at playback, they aren't entities yet
+		stats.entityIndices = static_cast<uint32_t>(m_EntityComponentSignature.size());
+		stats.freeIds = static_cast<uint32_t>(m_FreeIDs.size());
+		stats.liveEntities = stats.entityIndices - stats.freeIds;
+		stats.reservedIds = m_NumEntities.load() - stats.entityIndices;
+		stats.pendingAdd = static_cast<uint32_t>(m_EntitiesToBeAdded.size());
+		stats.pendingDestroy = static_cast<uint32_t>(m_EntitiesToBeDestroyed.size());
+		stats.pendingRefresh = static_cast<uint32_t>(m_EntitiesToRefresh.size());
+		stats.pendingCommands = 0;
+		for (const auto& buffer : m_CommandBuffers) {
+			stats.pendingCommands += static_cast<uint32_t>(buffer->GetCommandCount());
+		}
+
+		stats.entityBytes = GetEntityMemoryUsage();
+		stats.totalBytes = stats.entityBytes;
+
+		// clear() keeps the capacity, nothing below allocates once the vectors saw the biggest world
+		stats.pools.clear();
+		for (size_t componentId = 0; componentId < m_ComponentPools.size(); ++componentId) {
+			const IComponentPool* pool = m_ComponentPools[componentId].get();
+			if (!pool) continue;
+
+			ComponentPoolStats& poolStats = stats.pools.emplace_back();
+			poolStats.componentId = static_cast<uint16_t>(componentId);
+			poolStats.name = IComponent::GetTypeInfo(poolStats.componentId).name;
+			poolStats.count = pool->GetCount();
+			poolStats.capacity = pool->GetCapacity();
+			poolStats.sparsePages = pool->GetSparsePageCount();
+			poolStats.sparseBytes = pool->GetSparseMemoryUsage();
+			poolStats.bytes = pool->GetAllocationStats().bytesInUse;
+			stats.totalBytes += poolStats.bytes;
+		}
+
+		stats.systems.clear();
+		for (const System* system : m_SystemOrder) {
+			SystemStats& systemStats = stats.systems.emplace_back();
+			systemStats.name = system->GetName();
+			systemStats.entities = static_cast<uint32_t>(system->GetSystemEntities().size());
+			systemStats.capacity = static_cast<uint32_t>(system->GetSystemEntities().capacity());
+			systemStats.sparsePages = system->GetEntityIndexPageCount();
+			systemStats.sparseBytes = system->GetEntityIndexMemoryUsage();
+			systemStats.bytes = system->GetMemoryUsage();
+			stats.totalBytes += systemStats.bytes;
+		}
+
+		stats.archetypes.clear();
+		stats.archetypeBytes = 0;
+		if (m_StorageBackend == ECSStorageBackend::Archetype) {
+			for (const auto& archetype : m_ArchetypeStorage.GetArchetypes()) {
+				ArchetypeStats& archetypeStats = stats.archetypes.emplace_back();
+				archetypeStats.componentCount = static_cast<uint32_t>(archetype->GetSignature().count());
+				archetypeStats.entities = archetype->GetCount();
+				archetypeStats.chunks = archetype->GetChunkCount();
+				archetypeStats.capacity = archetype->GetChunkCount() * archetype->GetChunkCapacity();
+				archetypeStats.bytes = static_cast<size_t>(archetype->GetChunkCount()) * archetype->GetChunkBytes();
+			}
+			stats.archetypeBytes = m_ArchetypeStorage.GetMemoryUsage();
+			stats.totalBytes += stats.archetypeBytes;
+		}
 	}
 
 	void ECSOrchestrator::SetPrimaryCamera(Entity entity)
 	{
-		if (!entity.IsValid()) return;
+		if (!IsAlive(entity)) return;
 
 
 		// Signature of The Component itself
@@ -168,7 +733,7 @@ namespace AlphaEngine
 		cameraRequiredSignature.set(Component<CameraComponent>::GetId());
 
 		// The Signature of the Entity
-		const auto entityId = entity.GetId();
+		const auto entityId = entity.GetIndex();
 		const auto& entityCompSignature = m_EntityComponentSignature[entityId];
 
 		//Compare: Use bitwise AND to see if the camera bit is "on"
@@ -192,25 +757,48 @@ namespace AlphaEngine
 
 	void ECSOrchestrator::UpdateEntitiesLifeTime()
 	{
+		PlaybackCommandBuffers();
+
+		AddEntitiesToSystems(m_EntitiesToBeAdded);
 		for (auto entity : m_EntitiesToBeAdded)
 		{
-			AddEntityToSystems(entity);
+			m_PendingAdd[entity.GetIndex()] = 0;
 		}
 		m_EntitiesToBeAdded.clear();
 
-		for (auto entity : m_EntitiesToBeDestroyed)
+		// By index, a destroy hook is allowed to destroy more entities (they are handled in this same loop)
+		for (size_t i = 0; i < m_EntitiesToBeDestroyed.size(); ++i)
 		{
-			uint16_t id = entity.GetId();
+			const Entity entity = m_EntitiesToBeDestroyed[i];
+
+			// Destroying the same entity twice (or a stale handle) must not free the slot again
+			if (!IsAlive(entity)) continue;
+
+			uint32_t id = entity.GetIndex();
+
+			// Observers see the entity whole, before anything is removed.
+			// A hook may remove another of its components itself (which fires that one's hooks), so recheck the bit
+			const Signature signature = m_EntityComponentSignature[id];
+			ForEachComponent(signature, [&](uint16_t componentId) {
+				if (m_EntityComponentSignature[id].test(componentId)) FireHooks(m_DestroyHooks[componentId], entity);
+				});
 
 			RemoveEntityFromSystems(entity);
 
-			for (auto& pool : m_ComponentPools) {
-				if (pool) {
-					pool->RemoveEntityFromPool(id);
-				}
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				m_ArchetypeStorage.RemoveEntity(id);
+			}
+			else {
+				// Only the pools the entity actually has something in (tags don't have one)
+				ForEachComponent(m_EntityComponentSignature[id] & ~IComponent::GetTagSignature(), [&](uint16_t componentId) {
+					m_ComponentPools[componentId]->RemoveEntityFromPool(id);
+					});
 			}
-			m_EntityComponentSignature[entity.GetId()].reset();
-			m_FreeIDs.push_back(entity.GetId());
+			m_EntityComponentSignature[id].reset();
+
+			// Every handle still pointing to this slot is now stale
+			m_EntityGenerations[id] = (m_EntityGenerations[id] + 1) & Entity::GenerationMask;
+			m_FreeIDs.push_back(id);
 		}
 		m_EntitiesToBeDestroyed.clear();
 
@@ -222,11 +810,19 @@ namespace AlphaEngine
 
 		for (auto& entity : m_EntitiesToRefresh) {
 			// Only refresh if the entity wasn't just destroyed!
-			if (m_EntityComponentSignature[entity.GetId()].any()) {
+			// (an entity that lost its last component still has to leave its systems)
+			if (IsAlive(entity)) {
 				RefreshEntity(entity);
 			}
 		}
 		m_EntitiesToRefresh.clear();
+
+		// SetAutoCompact(), quietly skipped when a destroy hook recorded commands for the next frame
+		const size_t freeIds = m_FreeIDs.size();
+		if (m_AutoCompactRatio > 0.0f && freeIds > 0 && freeIds >= m_AutoCompactMinFreeIds &&
+			freeIds >= m_AutoCompactRatio * m_NumEntities.load() && CanCompact()) {
+			Compact();
+		}
 	}
 }
 
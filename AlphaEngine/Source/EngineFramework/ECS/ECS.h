@@ -8,57 +8,110 @@
 #include <set>
 #include "EngineFramework/Logger.h"
 #include "EngineFramework/ServiceLocator.h"
+#include "EngineFramework/ECS/ECSTypes.h"
+#include "EngineFramework/ECS/SignatureMatch.h"
+#include "EngineFramework/ECS/Archetype.h"
+#include "EngineFramework/ECS/ComponentPool.h"
+#include "EngineFramework/ECS/PagedSparseArray.h"
+#include "EngineFramework/ECS/MemoryResources.h"
+#include "EngineFramework/ECS/View.h"
+#include "EngineFramework/ECS/SystemScheduler.h"
+#include "EngineFramework/ECS/EntityCommandBuffer.h"
+#include "EngineFramework/ECS/Prefab.h"
+#include "EngineFramework/ECS/ECSStats.h"
 #include <memory>
+#include <memory_resource>
 #include <cassert>
 #include <deque>
+#include <algorithm>
+#include <span>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <array>
+#include <functional>
 #include <cstdint>
+#include <chrono>
 
 namespace AlphaEngine
 {
-	const uint16_t MAX_COMPONENTS = 32;
-	// Signature: We use a bitset (1s and 0s) to keep track of which
-	// components an entity has, and also helps keep track of which
-	// entities a system is interested in.
-	typedef std::bitset<MAX_COMPONENTS> Signature;
+	// How a system touches a component, the scheduler uses it to know which systems can run together
+	enum class ComponentAccess : uint8_t
+	{
+		Read,
+		ReadWrite
+	};
 
-	struct IComponent
+	enum class SystemTickMode : uint8_t
 	{
-	protected:
-		static uint16_t nextId;
+		// Runs whenever it is scheduled (the default)
+		EveryFrame,
+		// Runs at most once per frame, 'hz' times per second, for latency tolerant work like AI
+		FixedRate,
+		// Runs every frame but ForEachTickEntity() only hands out the next 1/'slices' of its entities,
+		// stopping early once 'budgetMicroseconds' are spent
+		TimeSliced,
+		// Only runs on the frame after RequestTick()
+		Manual
 	};
 
-	// Used to assign a unique id to a component type
-	template <typename T>
-	class Component : public IComponent
+	// When the orchestrator lets a system run, set with System::SetTickPolicy():
+	// SetTickPolicy(SystemTickPolicy::FixedRate(10.0f));
+	// SetTickPolicy(SystemTickPolicy::TimeSliced(4, 500));
+	struct SystemTickPolicy
 	{
-	public:
-		static int GetId()
-		{
-			static auto id = nextId++;
-			return id;
-		}
+		SystemTickMode mode = SystemTickMode::EveryFrame;
+		float hz = 0.0f;
+		uint32_t slices = 1;
+		// 0 -> no budget, only the slice limits the work
+		uint32_t budgetMicroseconds = 0;
+
+		static SystemTickPolicy EveryFrame() { return {}; }
+		static SystemTickPolicy FixedRate(float hz) { return { SystemTickMode::FixedRate, hz, 1, 0 }; }
+		static SystemTickPolicy TimeSliced(uint32_t slices, uint32_t budgetMicroseconds = 0) { return { SystemTickMode::TimeSliced, 0.0f, slices, budgetMicroseconds }; }
+		static SystemTickPolicy Manual() { return { SystemTickMode::Manual, 0.0f, 1, 0 }; }
 	};
 
-	class Entity
+	class ECSOrchestrator;
+
+	// Where every entity went when ECSOrchestrator::Compact() renumbered them:
+	// Entity now = remap(before);
+	// A handle that was already dead (or Null) before the compaction maps to Null
+	class EntityRemap
 	{
 	private:
-		uint16_t m_id;
-	public:
-		// Using the max value as Null
-		static constexpr uint16_t NullID = 0xFFFF;
+		friend class ECSOrchestrator;
 
-		Entity() : m_id(NullID) {};
-		Entity(uint16_t id) : m_id(id) {};
-		Entity(const Entity& entity) = default;
+		// [vector index = old entity index] the live handle that index had and the handle that entity has now,
+		// both Null for the indices that were free
+		std::vector<Entity> m_OldHandles;
+		std::vector<Entity> m_NewHandles;
+
+	public:
+		Entity operator () (Entity oldHandle) const
+		{
+			const uint32_t index = oldHandle.GetIndex();
+			if (!oldHandle.IsValid() || index >= m_OldHandles.size() || m_OldHandles[index] != oldHandle) return Entity();
+			return m_NewHandles[index];
+		}
 
-		uint16_t GetId() const;
-		bool IsValid() const { return m_id != NullID; }
+		// [span index = old entity index], for the containers that only ever hold live entities
+		std::span<const Entity> GetNewHandles() const { return m_NewHandles; }
+	};
 
-		Entity& operator = (const Entity& other) = default;
-		bool operator == (const Entity& other) const { return m_id == other.m_id; }
-		bool operator != (const Entity& other) const { return m_id == other.m_id; }
-		bool operator > (const Entity& other) const { return m_id > other.m_id; }
-		bool operator < (const Entity& other) const { return m_id < other.m_id; }
+	// What ECSOrchestrator::Compact() did
+	struct CompactStats
+	{
+		uint32_t liveEntities = 0;
+		// The entity index range before and after (the free ids are gone afterwards)
+		uint32_t indicesBefore = 0;
+		uint32_t indicesAfter = 0;
+		// GetMemoryUsage() before and after
+		size_t bytesBefore = 0;
+		size_t bytesAfter = 0;
+		double milliseconds = 0.0;
+
+		size_t GetBytesReclaimed() const { return bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0; }
 	};
 
 	// The System processes entities that contain a specific Signature
@@ -67,146 +120,225 @@ namespace AlphaEngine
 	private:
 		Signature m_ComponentSignature;
 
-		std::vector<Entity> m_Entities;
-
-		// the index of the vector is the Entity ID
-		// The value at that index is the Position in the m_ENtities array
-		std::vector<int> m_EntityToIndex;
+		// What the system touches while running (can be more than m_ComponentSignature,
+		// e.g. the RenderSystem reads the CameraComponent of the primary camera)
+		Signature m_ReadSignature;
+		Signature m_WriteSignature;
+
+		// OpenGL, Jolt, the EventBus and structural ECS changes are main thread only
+		bool m_RunsOnMainThread = false;
+
+		std::pmr::vector<Entity> m_Entities;
+
+		// the index is the Entity Index
+		// The value at that index is the Position in the m_ENtities array (-1 = not in the system)
+		// Paged so every system doesn't carry an array as big as the highest entity index
+		PagedSparseArray m_EntityToIndex;
+
+		// <--- Tick policy, advanced by ECSOrchestrator::BeginFrame() --->
+		SystemTickPolicy m_TickPolicy;
+		// Whether ScheduleSystem lets the system run this frame
+		bool m_TickDue = true;
+		bool m_TickRequested = false;
+		// FixedRate: time owed towards the next tick
+		float m_TickAccumulator = 0.0f;
+		// Time since the system last ran, handed to it as GetTickDeltaTime()
+		float m_TimeSinceTick = 0.0f;
+		float m_TickDeltaTime = 0.0f;
+		// TimeSliced: where in m_Entities the next slice starts
+		size_t m_SliceCursor = 0;
+
+		// typeid name of the system, set by AddSystem
+		const char* m_Name = "";
 
 	public:
-		System() { m_Entities.reserve(10000);  m_EntityToIndex.resize(10000, -1); };
-		~System() = default;
+		System() = default;
+		// Virtual, the orchestrator owns the systems through unique_ptr<System>
+		virtual ~System() = default;
 
 		void AddEntityToSystem(Entity entity);
 		void RemoveEntityFromSystem(Entity entity);
+		// Grows the lookup once so a batch of AddEntityToSystem calls doesn't have to
+		void ReserveEntityIndex(uint32_t maxEntityIndex);
 		bool HasEntity(Entity entity) const;
-		const std::vector<Entity>& GetSystemEntities() const;
-		const Signature& GetComponentSignature();
-
-		template <typename T>
-		void RequireComponent()
+		// Forgets every entity, the orchestrator adds them back (used when a snapshot replaces the world)
+		void ClearEntities();
+		// Compact(): entity i becomes newHandles[its old index], the order is kept
+		void RemapEntities(std::span<const Entity> newHandles);
+		// The entity list and its lookup
+		size_t GetMemoryUsage() const;
+		size_t GetEntityIndexMemoryUsage() const { return m_EntityToIndex.GetMemoryUsage(); }
+		uint32_t GetEntityIndexPageCount() const { return m_EntityToIndex.GetAllocatedPageCount(); }
+		const std::pmr::vector<Entity>& GetSystemEntities() const;
+		const Signature& GetComponentSignature() const;
+
+		const char* GetName() const { return m_Name; }
+		void SetName(const char* name) { m_Name = name; }
+
+		// Where the entity list and its lookup allocate from, AddSystem sets it to the orchestrator's
+		// bookkeeping resource. Only while the system has no entities (the old memory belongs to the old resource)
+		void SetMemoryResource(std::pmr::memory_resource* resource);
+
+		void SetTickPolicy(const SystemTickPolicy& policy);
+		const SystemTickPolicy& GetTickPolicy() const { return m_TickPolicy; }
+
+		// Called by the orchestrator once per frame, decides if the system is due this frame
+		void AdvanceTick(float frameDeltaTime);
+		bool IsTickDue() const { return m_TickDue; }
+		// Manual systems run on the next frame, the others ignore it
+		void RequestTick() { m_TickRequested = true; }
+
+		// The time the system's work covers: the frame time for EveryFrame/TimeSliced,
+		// the time since its last run for FixedRate/Manual (e.g. ~0.1s at 10 Hz)
+		float GetTickDeltaTime() const { return m_TickDeltaTime; }
+
+		// Calls f(entity) for the entities this tick is responsible for and returns how many it visited.
+		// TimeSliced -> the next 1/slices of GetSystemEntities(), cut short when the budget runs out and picked up
+		// from there on the next tick. Entities removed in between can shift the rotation a little, so a slice
+		// can skip or repeat an entity now and then. Everything else -> all of them
+		template <typename F>
+		size_t ForEachTickEntity(F&& f)
 		{
-			const auto componentId = Component<T>::GetId();
-			m_ComponentSignature.set(componentId);
-		}
-	};
-
+			const size_t entityCount = m_Entities.size();
+			if (entityCount == 0) return 0;
 
+			if (m_TickPolicy.mode != SystemTickMode::TimeSliced) {
+				for (size_t i = 0; i < entityCount; ++i) f(m_Entities[i]);
+				return entityCount;
+			}
 
-	class IComponentPool
-	{
-	public:
-		virtual ~IComponentPool() = default;
-		virtual void RemoveEntityFromPool(uint16_t entityId) = 0;
-	};
-
-	// Pool -> just a vector (contiguous data) of objects of type T
-	template <typename T>
-	class ComponentPool : public IComponentPool
-	{
-	private:
-
-		// Problem: 
-		// Index |   0			1			....			500				....			9999
-		// Data  |  [Health] [Health]		empty		 [Health]		   [empty]		  [Health]
-		// We do Dense - Sparse arrays because When our HealthSystem wants to update everyone, 
-		// the CPU has to "jump" from address 0 to address 500, then to address 999. This is a Cache Miss
-		// With Sparse set way:
-		//
-		// <------ The dense array (actualy comp data lives here) -------->
-		// Dense Index |	   0			1			2			
-		// Data		   |  [Health A] 	[Health B] 	[Health C]
-		//
-		// 
-		// <------ The Sparse array (where in the dense array to find that entity's data) -------->
-		// Entity ID	 |	   0			....			500				....			999			
-		// Value		 |     0			-1				1				-1				2
-
-		// The "Dense" array: Tightly packed component data for CPU cache speed
-		std::vector<T> m_Data;
-
-		// Maps Dense Index -> Entity ID (Needed for Swap-and-Pop)
-		std::vector<uint16_t> m_DenseToEntity;
-
-		// The "Sparse" array: Maps Entity ID -> Index in m_Data
-		// We use int because we need -1 to indicate "no component"
-		std::vector<int> m_EntityToIndex;
+			const size_t sliceSize = (entityCount + m_TickPolicy.slices - 1) / m_TickPolicy.slices;
+			if (m_SliceCursor >= entityCount) m_SliceCursor = 0;
 
-	public:
-		ComponentPool(uint16_t size = 1000) { m_Data.reserve(size); m_DenseToEntity.reserve(size); }
-		virtual ~ComponentPool() = default;
+			const bool hasBudget = m_TickPolicy.budgetMicroseconds > 0;
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(m_TickPolicy.budgetMicroseconds);
 
-		bool isEmpty() const { return m_Data.empty(); }
-		uint16_t GetSize() const { return m_Data.size(); }
-		void Clear() { m_Data.clear(); }
+			size_t visited = 0;
+			while (visited < sliceSize) {
+				f(m_Entities[m_SliceCursor]);
+				++visited;
+				if (++m_SliceCursor == entityCount) m_SliceCursor = 0;
 
-		void AddComp(uint16_t entityId, T Object)
-		{
-			// Grow Sparse array if needed
-			if (entityId >= m_EntityToIndex.size()) {
-				m_EntityToIndex.resize(entityId + 1, -1);
+				// Reading the clock costs about as much as a cheap entity, so only every 16
+				if (hasBudget && (visited & 15) == 0 && std::chrono::steady_clock::now() >= deadline) break;
 			}
-
-			// Map entity to the end of the dense array
-			m_EntityToIndex[entityId] = static_cast<int>(m_Data.size());
-
-			// Push data to the end
-			m_Data.push_back(std::move(Object));
-			m_DenseToEntity.push_back(entityId);
+			return visited;
 		}
 
-		void RemoveComp(uint16_t entityId)
-		{
-			int indexToRemove = m_EntityToIndex[entityId];
-			int lastIndex = static_cast<int>(m_Data.size()) - 1;
+		const Signature& GetReadSignature() const { return m_ReadSignature; }
+		const Signature& GetWriteSignature() const { return m_WriteSignature; }
+		bool RunsOnMainThread() const { return m_RunsOnMainThread; }
 
-			// Move last element to the hole
-			m_Data[indexToRemove] = std::move(m_Data[lastIndex]);
+		// Called by Compact() once the whole world was renumbered (GetSystemEntities() already has the new handles).
+		// Override it when the system keeps Entities or entity indices of its own
+		virtual void OnEntitiesRemapped(ECSOrchestrator& /*ecs*/, const EntityRemap& /*remap*/) {}
 
-			// Update mapings
-			uint16_t entityOfLastElement = m_DenseToEntity[lastIndex];
-			m_EntityToIndex[entityOfLastElement] = indexToRemove;
-			m_DenseToEntity[indexToRemove] = entityOfLastElement;
+		// Called right after the entity joined / left GetSystemEntities() (main thread, from UpdateEntitiesLifeTime
+		// or a snapshot restore). Override them when the system keeps an index of its members, e.g. the SpatialGridSystem
+		virtual void OnEntityAdded(Entity /*entity*/) {}
+		virtual void OnEntityRemoved(Entity /*entity*/) {}
 
-			// Cleanup
-			m_Data.pop_back();
-			m_DenseToEntity.pop_back();
-			m_EntityToIndex[entityId] = -1;
+		// The entity needs T to be part of this system.
+		// Default is ReadWrite so a system that doesn't say anything is never run next to something that conflicts
+		template <typename T>
+		void RequireComponent(ComponentAccess access = ComponentAccess::ReadWrite)
+		{
+			const auto componentId = Component<T>::GetId();
+			m_ComponentSignature.set(componentId);
+			DeclareAccess<T>(access);
 		}
 
-		void RemoveEntityFromPool(uint16_t entityId) override {
-			// Check if the entity is within range of our sparse array
-			// Check if the value is not -1 (meaning it actually has a component)
-			if (entityId < m_EntityToIndex.size() && m_EntityToIndex[entityId] != -1) {
-				RemoveComp(entityId); // This calls your Swap-and-Pop logic
+		// Touches T without requiring it (doesn't change which entities the system gets)
+		template <typename T>
+		void DeclareAccess(ComponentAccess access)
+		{
+			const auto componentId = Component<T>::GetId();
+			m_ReadSignature.set(componentId);
+			if (access == ComponentAccess::ReadWrite) {
+				m_WriteSignature.set(componentId);
 			}
 		}
-		T& Get(uint16_t entityId) {
-			assert(entityId < m_EntityToIndex.size() && m_EntityToIndex[entityId] != -1);
 
+	protected:
+		void SetRunsOnMainThread(bool mainThread) { m_RunsOnMainThread = mainThread; }
 
-			int index = m_EntityToIndex[entityId];
+		// The change tick claimed on the previous run, so a system can ask for "changed since my last run":
+		// const uint32_t since = m_LastRunTick; m_LastRunTick = ecs.ClaimChangeTick();
+		// for (auto [e, t] : ecs.View<TransformComponent>().Changed<TransformComponent>(since)) ...
+		uint32_t m_LastRunTick = 0;
+	};
 
+	struct ISystemType
+	{
+	protected:
+		static uint16_t nextId;
+	};
 
-			return m_Data[index];
+	// Used to assign a unique id to a system type, same idea as Component<T>::GetId().
+	// The id is the slot of the system in the orchestrator, so GetSystem<T>() is one indexed load instead of a hash of typeid(T)
+	template <typename T>
+	class SystemType : public ISystemType
+	{
+	public:
+		static uint16_t GetId()
+		{
+			static const uint16_t id = nextId++;
+			return id;
 		}
+	};
 
-		uint16_t GetCount() const {
-			return static_cast<uint16_t>(m_Data.size());
-		}
 
-		std::vector<T>& GetAllData() {
-			return m_Data;
-		}
+
+	// Where the component data actually lives.
+	// SparseSet -> one ComponentPool<T> per component type (fast add/remove)
+	// Archetype -> entities with the same Signature packed together in chunks (fast iteration)
+	// Selectable so we can benchmark both with the same game code
+	enum class ECSStorageBackend : uint8_t
+	{
+		SparseSet,
+		Archetype
+	};
+
+	// Where the orchestrator allocates from (see MemoryResources.h), nullptr -> the default heap.
+	// The resources must outlive the orchestrator
+	struct ECSMemoryConfig
+	{
+		// The pending lists, the free id list and the entity lists of the systems
+		std::pmr::memory_resource* bookkeeping = nullptr;
+		// Every component pool that doesn't get its own with SetComponentMemoryResource<T>()
+		std::pmr::memory_resource* components = nullptr;
 	};
 
+	class WorldSnapshot;
 
+	// Called with the entity whose component was just added / is about to be removed
+	using ComponentHookFn = std::function<void(ECSOrchestrator& ecs, Entity entity)>;
+	// Called after Compact() renumbered the entities, with where each one went
+	using CompactHookFn = std::function<void(ECSOrchestrator& ecs, const EntityRemap& remap)>;
 
 	// Registry -> Manages creation and destruction of entities, add systems and components
 	class ECSOrchestrator : public IService
 	{
 	private:
-		uint16_t m_NumEntities = 0;
+		// Reads and replaces the whole state in one go
+		friend class WorldSnapshot;
+		// Clones its values straight into the pools
+		friend class Prefab;
+		// Reserves the ids of the entities it records
+		friend class EntityCommandBuffer;
+
+		// Atomic so command buffers on other threads can reserve fresh indices while the main thread creates entities
+		std::atomic<uint32_t> m_NumEntities{ 0 };
+
+		ECSStorageBackend m_StorageBackend;
+
+		// Both resources are never null once constructed (the default heap stands in)
+		ECSMemoryConfig m_MemoryConfig;
+		// The resource every pool is created with [array index = component id], nullptr -> m_MemoryConfig.components
+		std::array<std::pmr::memory_resource*, MAX_COMPONENTS> m_PoolResources{};
+
+		// Only used when the backend is Archetype
+		ArchetypeStorage m_ArchetypeStorage;
 
 		// vector of component pools, each pool contains all the 
 		// data for a certain component type
@@ -214,44 +346,178 @@ namespace AlphaEngine
 		// pool index = entity id
 		std::vector<std::unique_ptr<IComponentPool>> m_ComponentPools;
 
+		// Owning groups over the pools (Sparse Set only). Declared after the pools so they die first
+		std::vector<std::unique_ptr<OwningGroup>> m_Groups;
+		// Groups we refused because one of their pools was already owned, so we only complain once
+		std::vector<Signature> m_RejectedGroups;
+
 		// Vector of component signatures.
 		// The signature lets us know which components are turned "on" for an entity
-		// [vector index = entity id]
+		// [vector index = entity index]
 		std::vector<Signature> m_EntityComponentSignature;
 
-		// Map of active systems [index = system typeid]
-		// TODO: --------------------> We could potentially use just a vector
-		// where the index is the System ID maybe , Little faster
-		std::unordered_map<std::type_index, std::unique_ptr<System>> m_Systems;
+		// Current generation of every entity slot, bumped when the slot is freed
+		// [vector index = entity index]
+		std::vector<uint16_t> m_EntityGenerations;
+
+		// Generation of the slots that are handed out for the first time. 0 until a Compact() drops the slots past
+		// the live range, then above every generation they had, so their stale handles can't come back to life
+		uint16_t m_FreshGeneration = 0;
+
+		// 1 while the entity waits in m_EntitiesToBeAdded. Those get matched against the systems
+		// with their final signature anyway, so adding components to them doesn't need a refresh
+		// [vector index = entity index]
+		std::vector<uint8_t> m_PendingAdd;
+
+		// Active systems [vector index = SystemType<T>::GetId()], nullptr for the types this world doesn't have.
+		// The ids are global, so a world with few systems can still have a few empty slots, that's fine
+		std::vector<std::unique_ptr<System>> m_Systems;
+		// The same systems in execution order: the order they were added in, unless SetSystemOrder() says otherwise.
+		// Everything that walks all the systems goes through this one, so the order never depends on the ids
+		std::vector<System*> m_SystemOrder;
+
+		// Which systems can care about a component, so a structural change only looks at those
+		// instead of AND-ing the signature of every system.
+		// [array index = component id] -> every system that requires that component
+		std::array<std::vector<System*>, MAX_COMPONENTS> m_SystemsWithComponent;
+		// [array index = component id] -> systems whose LOWEST required component is that one.
+		// An entity can only match a system if it has that component, so a new/destroyed entity
+		// checks each system at most once, and only the ones anchored on its own components
+		std::array<std::vector<System*>, MAX_COMPONENTS> m_SystemsAnchoredAt;
+		// The component signature of each of those systems, packed for SignatureMatch.h
+		// [array index = component id] [vector index = same as m_SystemsAnchoredAt]
+		std::array<std::vector<Signature>, MAX_COMPONENTS> m_AnchoredSignatures;
+		// Systems that require nothing get every entity
+		std::vector<System*> m_UnfilteredSystems;
+
+		// The signature the systems last matched the entity with, the next refresh only
+		// looks at the systems of the components that changed since
+		// [vector index = entity index]
+		std::vector<Signature> m_SystemSignatures;
+
+		// Observers [array index = component id]
+		std::array<std::vector<ComponentHookFn>, MAX_COMPONENTS> m_ConstructHooks;
+		std::array<std::vector<ComponentHookFn>, MAX_COMPONENTS> m_DestroyHooks;
+		std::vector<CompactHookFn> m_CompactHooks;
+
+		// SetAutoCompact(), 0 -> off
+		float m_AutoCompactRatio = 0.0f;
+		uint32_t m_AutoCompactMinFreeIds = 0;
+
+		// Nothing waits for UpdateEntitiesLifeTime (pending entities and recorded commands hold entity indices)
+		bool CanCompact() const;
+		// The per entity arrays, the free list and the pending queues
+		size_t GetEntityMemoryUsage() const;
+
+		void IndexSystem(System* system);
+		void UnindexSystem(System* system);
+
+		inline void FireHooks(const std::vector<ComponentHookFn>& hooks, Entity entity)
+		{
+			for (const auto& hook : hooks) hook(*this, entity);
+		}
+
+		// AddComponents helper, a tag in the batch has no pool to fill
+		template <typename T>
+		void AddToPool(std::span<const Entity> entities, std::span<T> components, uint32_t tick)
+		{
+			if constexpr (!IsTagComponent<T>) {
+				GetOrCreateComponentPool<T>()->AddComps(entities, components, tick);
+			}
+		}
 
 		// Set of entities that are flagged to be added or removed in the next
 		// registry Update()
 		// std::set is a tree, which means that every time we call create entity,
 		// the cpu has to allocate a new node and rebalance the tree.
 		// It would be better to use std::vector
-		std::vector<Entity> m_EntitiesToBeAdded;
-		std::vector<Entity> m_EntitiesToBeDestroyed;
+		// (pmr, they allocate from m_MemoryConfig.bookkeeping)
+		std::pmr::vector<Entity> m_EntitiesToBeAdded;
+		std::pmr::vector<Entity> m_EntitiesToBeDestroyed;
 		// Using this data structure so we add here the entities that need to 
 		// be refreshed and not Refresing every time But only once when we have all entities (Deffered
-		std::vector<Entity> m_EntitiesToRefresh;
+		std::pmr::vector<Entity> m_EntitiesToRefresh;
 
-		// List of free entity ids that were prev removed
-		std::vector<uint16_t> m_FreeIDs;
+		// List of free entity indices that were prev removed
+		std::pmr::vector<uint32_t> m_FreeIDs;
 
 		// Primary Camera ---------------> This creates Couple with!
 		Entity m_PrimaryCamera;
 
+		// Runs the systems of a frame in parallel based on their read/write signatures
+		SystemScheduler m_Scheduler;
+
+		// Every add/write stamps the component with the current tick.
+		// Starts at 1 so a system that never ran (m_LastRunTick = 0) sees everything.
+		// Atomic because systems on different workers claim ticks at the same time.
+		std::atomic<uint32_t> m_ChangeTick{ 1 };
+
+		// One command buffer per thread that ever asked for one, played back in UpdateEntitiesLifeTime
+		std::vector<std::unique_ptr<EntityCommandBuffer>> m_CommandBuffers;
+		// The buffer each thread already owns, so a thread going back and forth between orchestrators
+		// (and missing its cache every time) gets its old buffer back instead of a new one
+		std::unordered_map<std::thread::id, EntityCommandBuffer*> m_CommandBufferByThread;
+		// Only taken when a thread's cache misses, recording never locks
+		std::mutex m_CommandBufferMutex;
+
+		// The threads cache their buffer per orchestrator, this tells them the cache is stale
+		// (a new orchestrator can end up at the address of a destroyed one)
+		inline static std::atomic<uint32_t> s_NextInstanceId{ 1 };
+		const uint32_t m_InstanceId = s_NextInstanceId.fetch_add(1);
+
+		// Applies every recorded command in one sorted batch, start of UpdateEntitiesLifeTime
+		void PlaybackCommandBuffers();
+
+		// <--- Prefab instantiation helpers --->
+
+		// Copies one prefab value to every entity (the entities are fresh, so it never overwrites)
+		template <typename T>
+		void ClonePrefabComponent(std::span<const Entity> entities, const T& value, uint32_t tick)
+		{
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				for (const Entity& entity : entities) {
+					m_ArchetypeStorage.ConstructNew<T>(entity.GetIndex(), tick, value);
+				}
+			}
+			else {
+				GetOrCreateComponentPool<T>()->AddCopies(entities, value, tick);
+			}
+		}
+
+		// Places the new entities (archetype rows) and clones every prefab component except 'skipComponentId'
+		void ClonePrefab(const Prefab& prefab, std::span<const Entity> entities, const Signature& signature, int32_t skipComponentId, uint32_t tick);
+		// Sets the signatures in one pass and fires the construct hooks
+		void FinishInstantiate(std::span<const Entity> entities, const Signature& signature);
+
+		// Thread safe: hands out a fresh entity index without touching anything else.
+		// Only command buffers use it, their Create command makes the entity real on playback
+		// (only the playback grows the per entity arrays, a reserved id without its Create points past them).
+		// Reserved ids never come from the free list (that one is main thread only)
+		Entity ReserveEntity();
+
 	public:
-		ECSOrchestrator() { Logger::Log("Created The Orchestrator"); 
+		ECSOrchestrator(ECSStorageBackend storageBackend = ECSStorageBackend::SparseSet, const ECSMemoryConfig& memoryConfig = {})
+			: m_StorageBackend(storageBackend),
+			m_MemoryConfig{ memoryConfig.bookkeeping ? memoryConfig.bookkeeping : std::pmr::get_default_resource(),
+							memoryConfig.components ? memoryConfig.components : std::pmr::get_default_resource() },
+			m_EntitiesToBeAdded(m_MemoryConfig.bookkeeping), m_EntitiesToBeDestroyed(m_MemoryConfig.bookkeeping),
+			m_EntitiesToRefresh(m_MemoryConfig.bookkeeping), m_FreeIDs(m_MemoryConfig.bookkeeping) {
+		Logger::Log(storageBackend == ECSStorageBackend::Archetype ? "Created The Orchestrator (Archetype storage)" : "Created The Orchestrator (Sparse Set storage)");
 		m_EntitiesToBeAdded.reserve(1000);
 		m_EntitiesToBeDestroyed.reserve(1000);
 		m_EntitiesToRefresh.reserve(1000);
 		m_EntityComponentSignature.reserve(10000);
+		m_EntityGenerations.reserve(10000);
+		m_PendingAdd.reserve(10000);
+		m_SystemSignatures.reserve(10000);
 		};
 
 		virtual ~ECSOrchestrator() { Logger::Log("Destroyed The Orchestrator"); };
 		virtual void InitService() override { Logger::Log("Initializing Service named : ECS Orchestrator"); };
 
+		ECSStorageBackend GetStorageBackend() const { return m_StorageBackend; }
+		const ArchetypeStorage& GetArchetypeStorage() const { return m_ArchetypeStorage; }
+
 		// Update processes the entities that are waiting to be added/destroyed
 		void UpdateEntitiesLifeTime();
 
@@ -259,105 +525,522 @@ namespace AlphaEngine
 		Entity CreateEntity();
 		void DestroyEntity(Entity entity);
 
+		// Creates 'count' entities at once, the bookkeeping arrays grow once for the whole batch
+		std::vector<Entity> CreateEntities(uint32_t count);
+
+		// The command buffer of the calling thread, for structural changes from jobs and physics callbacks
+		EntityCommandBuffer& GetCommandBuffer();
+
+		// O(1) check that the handle still refers to the entity it was created for
+		// (the slot could have been freed and handed to a new entity since)
+		inline bool IsAlive(Entity entity) const
+		{
+			const uint32_t index = entity.GetIndex();
+			return entity.IsValid() && index < m_EntityGenerations.size() && m_EntityGenerations[index] == entity.GetGeneration();
+		}
+
 		// Component Management
 		template <typename T, typename ...TArgs>
 		void AddComponent(Entity entity, TArgs&& ...args)
 		{
 			const auto componentId = Component<T>::GetId();
-			const auto entityId = entity.GetId();
+			const auto entityId = entity.GetIndex();
+			assert(IsAlive(entity) && "Adding a component to a dead entity!");
 
-			// If not inside the vector
-			if (componentId >= m_ComponentPools.size())
+			if constexpr (IsTagComponent<T>) {
+				// A tag is only its signature bit, there is nothing to store
+			}
+			else if (m_StorageBackend == ECSStorageBackend::Archetype)
 			{
-				m_ComponentPools.resize(componentId + 1);
+				// The archetype storage moves the entity into the chunk of its new signature
+				m_ArchetypeStorage.Add<T>(entity, GetChangeTick(), std::forward<TArgs>(args)...);
 			}
+			else {
+				// When just using the pool we can use a raw pointer
+				auto* currentCompPool = GetOrCreateComponentPool<T>();
 
-			// If no pools at thta index
-			if (!m_ComponentPools[componentId])
-			{
-				m_ComponentPools[componentId] = std::make_unique<ComponentPool<T>>();
+				T newComponent(std::forward<TArgs>(args)...);
+
+				currentCompPool->AddComp(entity, std::move(newComponent), GetChangeTick());
+			}
+
+			// Overwriting an existing component is not a structural change
+			if (m_EntityComponentSignature[entityId].test(componentId)) return;
+
+			m_EntityComponentSignature[entityId].set(componentId);
+			if (!m_PendingAdd[entityId]) {
+				m_EntitiesToRefresh.push_back(entity);
 			}
+			FireHooks(m_ConstructHooks[componentId], entity);
+		}
+
 
-			// Fetch the pool either way,
-			// When just using the pool we can use a raw pointer
-			auto* currentCompPool = static_cast<ComponentPool<T>*>(m_ComponentPools[componentId].get());
+		// Bulk version of AddComponent, entity i gets components[i] of every span (the values are moved from).
+		// The Ts can't be deduced from vectors, so spell them out:
+		// ecs.AddComponents<TransformComponent, RenderComponent>(entities, transforms, renders);
+		// Every pool grows once, the signatures are set in one pass, and with the archetype backend
+		// each entity moves straight to its final archetype.
+		template <typename ...Ts>
+		void AddComponents(std::span<const Entity> entities, std::span<Ts>... components)
+		{
+			static_assert(sizeof...(Ts) > 0, "AddComponents needs at least one component type");
+			assert(((components.size() == entities.size()) && ...) && "Every component span needs one value per entity!");
 
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				// Skips the tags itself, they don't change the archetype
+				m_ArchetypeStorage.AddBatch<Ts...>(entities, GetChangeTick(), components...);
+			}
+			else {
+				const uint32_t tick = GetChangeTick();
+				(AddToPool<Ts>(entities, components, tick), ...);
+			}
 
-			T newComponent(std::forward<TArgs>(args)...);
+			Signature batchSignature;
+			(batchSignature.set(Component<Ts>::GetId()), ...);
 
-			currentCompPool->AddComp(entityId, std::move(newComponent));
+			bool hasHooks = false;
+			ForEachComponent(batchSignature, [&](uint16_t componentId) { hasHooks |= !m_ConstructHooks[componentId].empty(); });
 
-			m_EntityComponentSignature[entityId].set(componentId);
-			m_EntitiesToRefresh.push_back(entity);
+			for (const Entity& entity : entities) {
+				assert(IsAlive(entity) && "Adding a component to a dead entity!");
+				const auto entityId = entity.GetIndex();
+
+				const Signature addedSignature = batchSignature & ~m_EntityComponentSignature[entityId];
+				if (addedSignature.none()) continue;
+
+				m_EntityComponentSignature[entityId] |= batchSignature;
+				if (!m_PendingAdd[entityId]) {
+					m_EntitiesToRefresh.push_back(entity);
+				}
+
+				if (hasHooks) {
+					ForEachComponent(addedSignature, [&](uint16_t componentId) { FireHooks(m_ConstructHooks[componentId], entity); });
+				}
+			}
+		}
+
+		// Clones the prefab onto 'count' new entities, see Prefab.h.
+		// Every pool grows once, and like CreateEntities the systems get them in the next UpdateEntitiesLifeTime
+		std::vector<Entity> Instantiate(const Prefab& prefab, uint32_t count);
+
+		// Same, but entity i gets perInstance[i] for T instead of the prefab's value (moved from),
+		// usually where each one spawns: ecs.Instantiate(ballPrefab, count, std::span(ballTransforms))
+		template <typename T>
+		std::vector<Entity> Instantiate(const Prefab& prefab, uint32_t count, std::span<T> perInstance)
+		{
+			assert(perInstance.size() == count && "Instantiate needs one value per instance!");
+			const auto componentId = Component<T>::GetId();
+
+			Signature signature = prefab.GetSignature();
+			signature.set(componentId);
+
+			std::vector<Entity> entities = CreateEntities(count);
+			const uint32_t tick = GetChangeTick();
+			ClonePrefab(prefab, entities, signature, componentId, tick);
+
+			if constexpr (!IsTagComponent<T>) {
+				if (m_StorageBackend == ECSStorageBackend::Archetype) {
+					for (size_t i = 0; i < entities.size(); ++i) {
+						m_ArchetypeStorage.ConstructNew<T>(entities[i].GetIndex(), tick, std::move(perInstance[i]));
+					}
+				}
+				else {
+					AddToPool<T>(entities, perInstance, tick);
+				}
+			}
+
+			FinishInstantiate(entities, signature);
+			return entities;
 		}
 
 		template<typename T>
 		void RemoveComponent(Entity entity)
 		{
+			// A stale handle would remove (and fire the hooks of) whoever owns the slot now
+			if (!IsAlive(entity)) return;
+
 			const auto componentId = Component<T>::GetId();
-			const auto entityId = entity.GetId();
+			const auto entityId = entity.GetIndex();
 
-			if (componentId < m_ComponentPools.size() && m_ComponentPools[componentId]) {
+			if (!m_EntityComponentSignature[entityId].test(componentId)) return;
+
+			// The observers still get to read the component
+			FireHooks(m_DestroyHooks[componentId], entity);
+
+			if constexpr (IsTagComponent<T>) {
+				// Nothing stored, clearing the bit below is the whole removal
+			}
+			else if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				m_ArchetypeStorage.Remove(entity, static_cast<uint16_t>(componentId));
+			}
+			else if (static_cast<size_t>(componentId) < m_ComponentPools.size() && m_ComponentPools[componentId]) {
 				auto* pool = static_cast<ComponentPool<T>*>(m_ComponentPools[componentId].get());
 				pool->RemoveComp(entityId);
 			}
 
 			m_EntityComponentSignature[entityId].set(componentId, false);
-			m_EntitiesToRefresh.push_back(entity);
+			if (!m_PendingAdd[entityId]) {
+				m_EntitiesToRefresh.push_back(entity);
+			}
 		}
 
 		template<typename T>
 		bool HasComponent(Entity entity) const
 		{
+			// A stale handle has nothing, whatever the entity now in its slot has
+			if (!IsAlive(entity)) return false;
+
 			const auto componentId = Component<T>::GetId();
-			const auto entityId = entity.GetId();
+			const auto entityId = entity.GetIndex();
 			return m_EntityComponentSignature[entityId].test(componentId);
 		}
 
 		template<typename T>
 		T& GetComponent(Entity entity) const
 		{
+			static_assert(!IsTagComponent<T>, "Tags have no data to get, use HasComponent<T>()");
+			assert(IsAlive(entity) && "GetComponent on a dead entity!");
 			const auto componentId = Component<T>::GetId();
-			const auto entityId = entity.GetId();
+			const auto entityId = entity.GetIndex();
+
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				return *static_cast<T*>(m_ArchetypeStorage.GetComponent(entityId, static_cast<uint16_t>(componentId)));
+			}
+
 			auto* componentPool = static_cast<ComponentPool<T>*>(m_ComponentPools[componentId].get());
 			return componentPool->Get(entityId);
 		}
 
+		template<typename T>
+		ComponentPool<T>* GetOrCreateComponentPool()
+		{
+			static_assert(!IsTagComponent<T>, "Tags don't have a pool");
+			const auto componentId = Component<T>::GetId();
+
+			// If not inside the vector
+			if (componentId >= static_cast<int>(m_ComponentPools.size()))
+			{
+				m_ComponentPools.resize(componentId + 1);
+			}
+
+			// If no pools at thta index
+			if (!m_ComponentPools[componentId])
+			{
+				std::pmr::memory_resource* resource = m_PoolResources[componentId] ? m_PoolResources[componentId] : m_MemoryConfig.components;
+				m_ComponentPools[componentId] = std::make_unique<ComponentPool<T>>(resource);
+			}
+
+			return static_cast<ComponentPool<T>*>(m_ComponentPools[componentId].get());
+		}
+
+		// <--- Memory --->
+
+		// The pool of T allocates from 'resource' (must outlive the orchestrator), e.g. a ChurnPoolResource
+		// for projectiles or a LargePageArena for level geometry. Has to be called before the pool exists,
+		// the memory of a live pool can't change owner. Sparse set backend only, the archetype chunks use the heap
+		template<typename T>
+		void SetComponentMemoryResource(std::pmr::memory_resource* resource)
+		{
+			static_assert(!IsTagComponent<T>, "Tags don't have a pool");
+			const auto componentId = Component<T>::GetId();
+			if (componentId < m_ComponentPools.size() && m_ComponentPools[componentId]) {
+				Logger::Err("SetComponentMemoryResource: the pool already exists, ignored");
+				return;
+			}
+			m_PoolResources[componentId] = resource;
+		}
+
+		// What the pool of T allocated so far (all zero if it doesn't exist yet)
+		template<typename T>
+		AllocationStats GetComponentAllocationStats() const
+		{
+			const IComponentPool* pool = GetComponentPool<T>();
+			return pool ? pool->GetAllocationStats() : AllocationStats{};
+		}
+
+		const ECSMemoryConfig& GetMemoryConfig() const { return m_MemoryConfig; }
+
+		// Owning group over the Ts: iterating it is a straight index walk over aligned pools.
+		// The first call creates the group and sorts the pools, afterwards every add/remove keeps it in order.
+		// A pool can only be owned by ONE group, asking for a second one that overlaps falls back to a View.
+		// With the archetype backend the chunks are already aligned, so this is just View<Ts...>()
+		template<typename ...Ts>
+		ComponentView<Ts...> Group()
+		{
+			static_assert(sizeof...(Ts) > 1, "A group needs at least two component types");
+
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				return View<Ts...>();
+			}
+
+			Signature groupSignature;
+			(groupSignature.set(Component<Ts>::GetId()), ...);
+
+			for (const auto& group : m_Groups) {
+				if (group->GetSignature() == groupSignature) {
+					return ComponentView<Ts...>(*group, m_EntityComponentSignature, GetComponentPool<Ts>()...);
+				}
+			}
+
+			if (std::find(m_RejectedGroups.begin(), m_RejectedGroups.end(), groupSignature) != m_RejectedGroups.end()) {
+				return View<Ts...>();
+			}
+
+			std::vector<IComponentPool*> pools{ GetOrCreateComponentPool<Ts>()... };
+			for (IComponentPool* pool : pools) {
+				if (pool->GetOwningGroup() != nullptr) {
+					Logger::Err("Group: a component is already owned by another group, falling back to a View");
+					m_RejectedGroups.push_back(groupSignature);
+					return View<Ts...>();
+				}
+			}
+
+			m_Groups.push_back(std::make_unique<OwningGroup>(groupSignature, std::move(pools)));
+			return ComponentView<Ts...>(*m_Groups.back(), m_EntityComponentSignature, GetComponentPool<Ts>()...);
+		}
+
+		// <--- Observers --->
+
+		// Called every time T is added to an entity that didn't have it (overwriting doesn't count).
+		// Runs right inside AddComponent, so keep it cheap and don't destroy the entity from there
+		template<typename T>
+		void OnConstruct(ComponentHookFn hook)
+		{
+			m_ConstructHooks[Component<T>::GetId()].push_back(std::move(hook));
+		}
+
+		// Called right before T is removed, either by RemoveComponent or because the entity is destroyed
+		template<typename T>
+		void OnDestroy(ComponentHookFn hook)
+		{
+			m_DestroyHooks[Component<T>::GetId()].push_back(std::move(hook));
+		}
+
+		template<typename T>
+		void ClearComponentHooks()
+		{
+			m_ConstructHooks[Component<T>::GetId()].clear();
+			m_DestroyHooks[Component<T>::GetId()].clear();
+		}
+
+		// Called with the EntityRemap of every Compact(), for whoever holds on to Entity handles
+		// outside the ECS (gameplay code, UI, ...). Systems override System::OnEntitiesRemapped instead
+		void OnCompact(CompactHookFn hook)
+		{
+			m_CompactHooks.push_back(std::move(hook));
+		}
+
+		// <--- Compaction --->
+
+		// Spawn/despawn cycles leave the free ids scattered (they are reused last in, first out) and every array
+		// sized for the peak. Compact() gives the memory back:
+		// - renumbers the live entities to 0..N-1, keeping their order (the ones before the first hole keep their handle)
+		// - remaps the pools, the archetype rows, the system lists and the primary camera, then calls
+		//   System::OnEntitiesRemapped and the OnCompact hooks (hierarchy links, physics user data, gameplay handles)
+		// - shrinks the entity arrays, the dense arrays of the pools, the sparse pages and the empty archetype chunks
+		// Every other handle from before the compaction has to go through the remap: IsAlive() says false for the stale
+		// ones, but a stale handle that still passes the check (a 12 bit generation wraps) would point at someone else.
+		// Call it between frames, after UpdateEntitiesLifeTime (it refuses while anything is pending)
+		CompactStats Compact();
+
+		// Compacts at the end of UpdateEntitiesLifeTime once at least 'minFreeIds' ids are free and they are
+		// at least 'freeRatio' of all the ids handed out, e.g. SetAutoCompact(0.5f, 4096). 0 turns it off
+		void SetAutoCompact(float freeRatio, uint32_t minFreeIds = 1024)
+		{
+			m_AutoCompactRatio = freeRatio;
+			m_AutoCompactMinFreeIds = minFreeIds;
+		}
+
+		// Bytes the ECS holds right now: entity arrays, queues, pools (sparse pages included), archetype chunks and system lists
+		size_t GetMemoryUsage() const;
+
+		// Counts and bytes per pool, system and archetype plus the entity bookkeeping (see ECSStats.h).
+		// Reuses the vectors of 'stats', so sampling it every frame doesn't allocate once they are big enough
+		void GetStats(ECSStats& stats) const;
+		ECSStats GetStats() const
+		{
+			ECSStats stats;
+			GetStats(stats);
+			return stats;
+		}
+
+		// <--- Change versioning --->
+
+		uint32_t GetChangeTick() const { return m_ChangeTick.load(std::memory_order_relaxed); }
+
+		// Returns the current tick and moves on, anything stamped from now on is newer than the returned value
+		uint32_t ClaimChangeTick() { return m_ChangeTick.fetch_add(1, std::memory_order_relaxed); }
+
+		// Writing through GetComponent/Views doesn't stamp anything, call this after modifying T
+		template<typename T>
+		void MarkChanged(Entity entity)
+		{
+			static_assert(!IsTagComponent<T>, "Tags have no data and no change ticks");
+			const auto componentId = Component<T>::GetId();
+			const auto entityId = entity.GetIndex();
+			assert(m_EntityComponentSignature[entityId].test(componentId) && "Entity doesn't have this component!");
+
+			if (m_StorageBackend == ECSStorageBackend::Archetype) {
+				m_ArchetypeStorage.MarkChanged(entityId, static_cast<uint16_t>(componentId), GetChangeTick());
+				return;
+			}
+			m_ComponentPools[componentId]->MarkChanged(entityId, GetChangeTick());
+		}
+
+		// GetComponent for writing: stamps T as changed and hands it out
+		template<typename T>
+		T& PatchComponent(Entity entity)
+		{
+			MarkChanged<T>(entity);
+			return GetComponent<T>(entity);
+		}
+
+		// Returns nullptr if nobody ever added a T
+		template<typename T>
+		ComponentPool<T>* GetComponentPool() const
+		{
+			static_assert(!IsTagComponent<T>, "Tags don't have a pool");
+			const auto componentId = Component<T>::GetId();
+			if (componentId >= static_cast<int>(m_ComponentPools.size())) return nullptr;
+			return static_cast<ComponentPool<T>*>(m_ComponentPools[componentId].get());
+		}
+
+		// Iterate every entity that has all the Ts, the pools (or archetypes) are resolved once here.
+		// Tags can't be iterated (nothing to hand out), filter on them instead:
+		// ecs.View<TransformComponent>().With<IsStatic>().Without<Sleeping>()
+		template<typename ...Ts>
+		ComponentView<Ts...> View() const
+		{
+			static_assert(((!IsTagComponent<Ts>) && ...), "Tags can't be viewed, use View<...>().With<Tag>()");
+
+			if (m_StorageBackend == ECSStorageBackend::Archetype)
+			{
+				Signature viewSignature;
+				(viewSignature.set(Component<Ts>::GetId()), ...);
+
+				std::vector<const Archetype*> matchingArchetypes;
+				const auto& archetypes = m_ArchetypeStorage.GetArchetypes();
+				const auto& signatures = m_ArchetypeStorage.GetSignatures();
+				ForEachSignatureContaining(signatures.data(), signatures.size(), viewSignature, [&](size_t index) {
+					matchingArchetypes.push_back(archetypes[index].get());
+					});
+				return ComponentView<Ts...>(std::move(matchingArchetypes), m_EntityComponentSignature);
+			}
+
+			return ComponentView<Ts...>(m_EntityComponentSignature, GetComponentPool<Ts>()...);
+		}
+
 		// System Management
+		// Returns the new system so the caller can keep the pointer around instead of asking for it every frame
 		template <typename T, typename ...TArgs>
-		void AddSystem(TArgs&& ...args)
+		T& AddSystem(TArgs&& ...args)
 		{
-			// Creating the new System and forwarding the arguments correctly
-			// and then move it to our System data structure by making a pair
+			const uint16_t systemId = SystemType<T>::GetId();
+			if (systemId >= m_Systems.size()) {
+				m_Systems.resize(systemId + 1);
+			}
+			if (m_Systems[systemId]) {
+				Logger::Err(std::string("AddSystem: ") + typeid(T).name() + " already exists, keeping the old one");
+				return *static_cast<T*>(m_Systems[systemId].get());
+			}
+
+			// The signature is read here to index the system, so RequireComponent belongs in the constructor
 			std::unique_ptr<T> newSystem = std::make_unique<T>(std::forward<TArgs>(args)...);
-			m_Systems.insert(std::make_pair(std::type_index(typeid(T)), std::move(newSystem)));
+			newSystem->SetMemoryResource(m_MemoryConfig.bookkeeping);
+			newSystem->SetName(typeid(T).name());
+
+			T& system = *newSystem;
+			m_Systems[systemId] = std::move(newSystem);
+			m_SystemOrder.push_back(&system);
+			IndexSystem(&system);
+			return system;
 		}
 
 		template <typename T>
 		void RemoveSystem()
 		{
-			m_Systems.erase(std::type_index(typeid(T)));
+			const uint16_t systemId = SystemType<T>::GetId();
+			if (systemId >= m_Systems.size() || !m_Systems[systemId]) return;
+
+			System* system = m_Systems[systemId].get();
+			UnindexSystem(system);
+			m_SystemOrder.erase(std::find(m_SystemOrder.begin(), m_SystemOrder.end(), system));
+			m_Systems[systemId].reset();
 		}
 
 		template <typename T>
 		bool HasSystem() const
 		{
-			return m_Systems.find(std::type_index(typeid(T))) != m_Systems.end();
+			const uint16_t systemId = SystemType<T>::GetId();
+			return systemId < m_Systems.size() && m_Systems[systemId];
 		}
 
 		template <typename T>
 		T& GetSystem() const
 		{
-			auto it = m_Systems.find(std::type_index(typeid(T)));
-			assert(it != m_Systems.end() && "System does not exist!");
-			return *static_cast<T*>(it->second.get());
+			const uint16_t systemId = SystemType<T>::GetId();
+			assert(systemId < m_Systems.size() && m_Systems[systemId] && "System does not exist!");
+			return *static_cast<T*>(m_Systems[systemId].get());
+		}
+
+		// Moves Ts to the front of the execution order, in the order given. The systems not listed keep their order after them:
+		// ecs.SetSystemOrder<PlayerControllerSystem, PhysicsSystem, TransformSystem, CameraSystem>();
+		template <typename ...Ts>
+		void SetSystemOrder()
+		{
+			std::vector<System*> order;
+			order.reserve(m_SystemOrder.size());
+			(order.push_back(&GetSystem<Ts>()), ...);
+
+			for (System* system : m_SystemOrder) {
+				if (std::find(order.begin(), order.end(), system) == order.end()) {
+					order.push_back(system);
+				}
+			}
+			assert(order.size() == m_SystemOrder.size() && "SetSystemOrder: a system is listed twice");
+			m_SystemOrder = std::move(order);
+		}
+
+		// Every system, in execution order
+		const std::vector<System*>& GetSystems() const { return m_SystemOrder; }
+
+		// Once per frame before scheduling anything: lets every system's SystemTickPolicy decide if it runs this frame
+		void BeginFrame(float deltaTime);
+
+		// Runs a Manual system on the next frame
+		template <typename T>
+		void RequestSystemTick() { GetSystem<T>().RequestTick(); }
+
+		// For the systems that are called directly instead of scheduled
+		template <typename T>
+		bool IsSystemDue() const { return GetSystem<T>().IsTickDue(); }
+
+		// Queues the system for the next RunScheduledSystems(), 'work' receives the system itself:
+		// ecs.ScheduleSystem<CameraSystem>([&](CameraSystem& system) { system.RunSystem(ecs); });
+		// Systems are ordered like they are scheduled whenever their signatures conflict.
+		// Does nothing when the system's tick policy says it isn't due this frame
+		template <typename T, typename F>
+		void ScheduleSystem(F&& work)
+		{
+			T& system = GetSystem<T>();
+			if (!system.IsTickDue()) return;
+
+			m_Scheduler.AddJob(typeid(T).name(), system.GetReadSignature(), system.GetWriteSignature(), system.RunsOnMainThread(),
+				[&system, work = std::forward<F>(work)]() mutable { work(system); });
 		}
 
+		// Blocks until every scheduled system finished
+		void RunScheduledSystems() { m_Scheduler.Run(); }
+
+		SystemScheduler& GetScheduler() { return m_Scheduler; }
+		const SystemScheduler& GetScheduler() const { return m_Scheduler; }
 
 		// Checks the component signature of an entity and add
 		// the entity to the systems that are interested in it
 		// Also Remove them
 		void AddEntityToSystems(Entity entity);
+		// Same for a whole batch, but loops the systems once instead of once per entity
+		void AddEntitiesToSystems(std::span<const Entity> entities);
 		void RemoveEntityFromSystems(Entity entity);
 		void RefreshEntity(Entity entity);
 
@@ -366,4 +1049,30 @@ namespace AlphaEngine
 		Entity GetPrimaryCamera() const;
 
 	};
-}
\ No newline at end of file
+
+	template <typename T>
+	void Prefab::CloneInto(ECSOrchestrator& ecs, std::span<const Entity> entities, const void* value, uint32_t tick)
+	{
+		ecs.ClonePrefabComponent<T>(entities, *static_cast<const T*>(value), tick);
+	}
+
+	template <typename T>
+	void EntityCommandBuffer::ApplyAdd(ECSOrchestrator& ecs, Entity entity, void* payload)
+	{
+		if constexpr (IsTagComponent<T>) {
+			ecs.AddComponent<T>(entity);
+		}
+		else {
+			ecs.AddComponent<T>(entity, std::move(*static_cast<T*>(payload)));
+		}
+	}
+
+	template <typename T>
+	void EntityCommandBuffer::ApplyRemove(ECSOrchestrator& ecs, Entity entity, void* payload)
+	{
+		// Somebody else may have removed it first
+		if (ecs.HasComponent<T>(entity)) {
+			ecs.RemoveComponent<T>(entity);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#include "EngineFramework/ECS/ECSStats.h"
+#include "EngineFramework/Logger.h"
+#include <format>
+#include <fstream>
+
+namespace AlphaEngine
+{
+	static std::string EscapeJson(const char* text)
+	{
+		std::string escaped;
+		for (; *text != '\0'; ++text) {
+			if (*text == '"' || *text == '\\') escaped += '\\';
+			escaped += *text;
+		}
+		return escaped;
+	}
+
+	void ECSStats::Log() const
+	{
+		Logger::Log(std::format("ECS ({}): {} live entities, {} ids, {} free, {} reserved | pending add {} destroy {} refresh {} commands {} | {} KB total, {} KB entities, {} KB archetypes",
+			backend, liveEntities, entityIndices, freeIds, reservedIds, pendingAdd, pendingDestroy, pendingRefresh, pendingCommands,
+			totalBytes / 1024, entityBytes / 1024, archetypeBytes / 1024));
+
+		for (const ComponentPoolStats& pool : pools) {
+			Logger::Log(std::format("  pool {} ({}): {} / {} components, {} sparse pages ({} KB), {} KB",
+				pool.componentId, pool.name, pool.count, pool.capacity, pool.sparsePages, pool.sparseBytes / 1024, pool.bytes / 1024));
+		}
+		for (const SystemStats& system : systems) {
+			Logger::Log(std::format("  system {}: {} / {} entities, {} sparse pages ({} KB), {} KB",
+				system.name, system.entities, system.capacity, system.sparsePages, system.sparseBytes / 1024, system.bytes / 1024));
+		}
+		for (size_t i = 0; i < archetypes.size(); ++i) {
+			const ArchetypeStats& archetype = archetypes[i];
+			Logger::Log(std::format("  archetype {} ({} components): {} / {} entities in {} chunks, {} KB",
+				i, archetype.componentCount, archetype.entities, archetype.capacity, archetype.chunks, archetype.bytes / 1024));
+		}
+	}
+
+	void ECSStats::WriteJson(std::ostream& out) const
+	{
+		out << "{\n";
+		out << "  \"backend\": \"" << backend << "\",\n";
+		out << "  \"entity_indices\": " << entityIndices << ", \"live_entities\": " << liveEntities << ", \"free_ids\": " << freeIds
+			<< ", \"reserved_ids\": " << reservedIds << ",\n";
+		out << "  \"pending_add\": " << pendingAdd << ", \"pending_destroy\": " << pendingDestroy << ", \"pending_refresh\": " << pendingRefresh
+			<< ", \"pending_commands\": " << pendingCommands << ",\n";
+		out << "  \"entity_bytes\": " << entityBytes << ", \"archetype_bytes\": " << archetypeBytes << ", \"total_bytes\": " << totalBytes << ",\n";
+
+		out << "  \"pools\": [\n";
+		for (size_t i = 0; i < pools.size(); ++i) {
+			const ComponentPoolStats& pool = pools[i];
+			out << "    {\"id\": " << pool.componentId << ", \"name\": \"" << EscapeJson(pool.name) << "\", \"count\": " << pool.count
+				<< ", \"capacity\": " << pool.capacity << ", \"sparse_pages\": " << pool.sparsePages << ", \"sparse_bytes\": " << pool.sparseBytes
+				<< ", \"bytes\": " << pool.bytes << "}" << (i + 1 < pools.size() ? "," : "") << "\n";
+		}
+		out << "  ],\n";
+
+		out << "  \"systems\": [\n";
+		for (size_t i = 0; i < systems.size(); ++i) {
+			const SystemStats& system = systems[i];
+			out << "    {\"name\": \"" << EscapeJson(system.name) << "\", \"entities\": " << system.entities << ", \"capacity\": " << system.capacity
+				<< ", \"sparse_pages\": " << system.sparsePages << ", \"sparse_bytes\": " << system.sparseBytes
+				<< ", \"bytes\": " << system.bytes << "}" << (i + 1 < systems.size() ? "," : "") << "\n";
+		}
+		out << "  ],\n";
+
+		out << "  \"archetypes\": [\n";
+		for (size_t i = 0; i < archetypes.size(); ++i) {
+			const ArchetypeStats& archetype = archetypes[i];
+			out << "    {\"components\": " << archetype.componentCount << ", \"entities\": " << archetype.entities << ", \"chunks\": " << archetype.chunks
+				<< ", \"capacity\": " << archetype.capacity << ", \"bytes\": " << archetype.bytes << "}" << (i + 1 < archetypes.size() ? "," : "") << "\n";
+		}
+		out << "  ]\n";
+		out << "}\n";
+	}
+
+	bool ECSStats::WriteJsonFile(const std::string& path) const
+	{
+		std::ofstream file(path);
+		if (!file) {
+			Logger::Err("ECSStats: can't write '" + path + "'");
+			return false;
+		}
+		WriteJson(file);
+		return true;
+	}
+}
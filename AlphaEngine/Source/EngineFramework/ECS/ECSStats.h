@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace AlphaEngine
+{
+	// <-------------------------- ECS Stats ----------------------------->
+	//
+	// Where the memory of the world goes, filled by ECSOrchestrator::GetStats().
+	// Meant to be sampled every frame (or every few) in soak tests to catch something that only ever grows:
+	//
+	// ECSStats stats;           // keep it around, GetStats(stats) reuses its vectors
+	// ecs.GetStats(stats);
+	// stats.Log();              // or stats.WriteJsonFile("ecs_stats.json")
+	//
+	// Filling it only reads sizes and capacities (no walking the entities), so the cost is per pool and per system.
+	// The names are typeid names, mangled on GCC/Clang
+
+	struct ComponentPoolStats
+	{
+		uint16_t componentId = 0;
+		const char* name = "";
+		// Components in the pool, and how many fit before the dense arrays grow
+		uint32_t count = 0;
+		uint32_t capacity = 0;
+		// Allocated pages of the sparse array (PagedSparseArray::PAGE_SIZE entities each), and what they cost with the page table
+		uint32_t sparsePages = 0;
+		size_t sparseBytes = 0;
+		// Everything the pool allocated: dense data, entities, change ticks and the sparse array
+		size_t bytes = 0;
+	};
+
+	struct SystemStats
+	{
+		const char* name = "";
+		// Entities in the system, and how many the list holds before it grows
+		uint32_t entities = 0;
+		uint32_t capacity = 0;
+		// The m_EntityToIndex lookup
+		uint32_t sparsePages = 0;
+		size_t sparseBytes = 0;
+		// The entity list plus the lookup
+		size_t bytes = 0;
+	};
+
+	// Archetype backend only, one per archetype that ever existed (they are never destroyed, Compact() frees their chunks)
+	struct ArchetypeStats
+	{
+		uint32_t componentCount = 0;
+		uint32_t entities = 0;
+		uint32_t chunks = 0;
+		// Entities the chunks can hold
+		uint32_t capacity = 0;
+		size_t bytes = 0;
+	};
+
+	struct ECSStats
+	{
+		const char* backend = "";
+
+		// Entity ids handed out so far (live + free), the live ones and the free list
+		uint32_t entityIndices = 0;
+		uint32_t liveEntities = 0;
+		uint32_t freeIds = 0;
+		// Reserved by a command buffer, not created until the next playback
+		uint32_t reservedIds = 0;
+
+		// Waiting for the next UpdateEntitiesLifeTime()
+		uint32_t pendingAdd = 0;
+		uint32_t pendingDestroy = 0;
+		uint32_t pendingRefresh = 0;
+		uint32_t pendingCommands = 0;
+
+		// The per entity arrays (signatures, generations), the free list and the pending queues
+		size_t entityBytes = 0;
+		// The archetype chunks and the entity -> chunk row lookup
+		size_t archetypeBytes = 0;
+		// Everything, same as ECSOrchestrator::GetMemoryUsage()
+		size_t totalBytes = 0;
+
+		std::vector<ComponentPoolStats> pools;
+		std::vector<SystemStats> systems;
+		std::vector<ArchetypeStats> archetypes;
+
+		// One line for the totals, one per pool/system/archetype
+		void Log() const;
+		void WriteJson(std::ostream& out) const;
+		// false when the file can't be written
+		bool WriteJsonFile(const std::string& path) const;
+	};
+}
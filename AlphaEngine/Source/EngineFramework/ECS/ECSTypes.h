@@ -0,0 +1,122 @@
+#pragma once
+
+#include "EngineFramework/ECS/Signature.h"
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <utility>
+#include <bit>
+#include <type_traits>
+#include <typeinfo>
+
+namespace AlphaEngine
+{
+	// Empty structs (IsStatic, IsPlayer, Sleeping...) are tags: they only exist as a bit in the entity Signature,
+	// there is no pool (or archetype column) behind them, so tagging an entity costs nothing but the bit.
+	// AddComponent/RemoveComponent/HasComponent/RequireComponent work the same, GetComponent doesn't compile
+	template <typename T>
+	inline constexpr bool IsTagComponent = std::is_empty_v<T>;
+
+	// Type erased description of a component.
+	// The sparse set pools know their T at compile time, but the archetype chunks
+	// only know the component id, so they need these to move and destroy the raw bytes
+	struct ComponentTypeInfo
+	{
+		uint32_t size = 0;
+		uint32_t alignment = 0;
+		void (*moveConstruct)(void* destination, void* source) = nullptr;
+		void (*destruct)(void* object) = nullptr;
+		bool isTag = false;
+		// typeid(T).name(), for the stats and the logs (mangled on GCC/Clang)
+		const char* name = "";
+	};
+
+	struct IComponent
+	{
+	protected:
+		static uint16_t nextId;
+
+		// [vector index = component id]
+		inline static std::vector<ComponentTypeInfo> s_TypeInfos;
+		// Every tag component id, so type erased code knows which bits have no storage behind them
+		inline static Signature s_TagSignature;
+
+	public:
+		static const ComponentTypeInfo& GetTypeInfo(uint16_t componentId) { return s_TypeInfos[componentId]; }
+		static const Signature& GetTagSignature() { return s_TagSignature; }
+	};
+
+	// Used to assign a unique id to a component type
+	template <typename T>
+	class Component : public IComponent
+	{
+	public:
+		static int GetId()
+		{
+			static auto id = RegisterType();
+			return id;
+		}
+
+	private:
+		// Runs only once per component type, the first time anybody asks for its id
+		static uint16_t RegisterType()
+		{
+			const uint16_t id = nextId++;
+			assert(id < MAX_COMPONENTS && "Too many component types! Raise MAX_COMPONENTS");
+
+			if (id >= s_TypeInfos.size()) {
+				s_TypeInfos.resize(id + 1);
+			}
+
+			ComponentTypeInfo& info = s_TypeInfos[id];
+			info.size = sizeof(T);
+			info.alignment = alignof(T);
+			info.moveConstruct = [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); };
+			info.destruct = [](void* object) { static_cast<T*>(object)->~T(); };
+			info.isTag = IsTagComponent<T>;
+			info.name = typeid(T).name();
+			if (info.isTag) s_TagSignature.set(id);
+
+			return id;
+		}
+	};
+
+	// An Entity is just a 32 bit handle:
+	// | Generation (12 bits) | Index (20 bits) |
+	// Index -> the slot in all our arrays (signatures, sparse arrays) so it can be recycled
+	// Generation -> bumped every time a slot is recycled, so an old handle that still points
+	// to that slot is detected as dead instead of silently touching the new entity
+	class Entity
+	{
+	private:
+		uint32_t m_id;
+	public:
+		static constexpr uint32_t IndexBits = 20;
+		static constexpr uint32_t GenerationBits = 12;
+		static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+		static constexpr uint32_t GenerationMask = (1u << GenerationBits) - 1;
+
+		// Using the max value as Null, the last index is never handed out
+		// so a real entity can never look like Null (1,048,575 live entities max)
+		static constexpr uint32_t NullID = 0xFFFFFFFF;
+		static constexpr uint32_t MaxEntities = IndexMask;
+
+		Entity() : m_id(NullID) {};
+		explicit Entity(uint32_t id) : m_id(id) {};
+		Entity(uint32_t index, uint32_t generation) : m_id(((generation & GenerationMask) << IndexBits) | (index & IndexMask)) {};
+		Entity(const Entity& entity) = default;
+
+		// The full handle (index + generation), this is what we hand to other libraries like Jolt
+		uint32_t GetId() const;
+		inline uint32_t GetIndex() const { return m_id & IndexMask; }
+		inline uint32_t GetGeneration() const { return m_id >> IndexBits; }
+		bool IsValid() const { return m_id != NullID; }
+
+		Entity& operator = (const Entity& other) = default;
+		bool operator == (const Entity& other) const { return m_id == other.m_id; }
+		bool operator != (const Entity& other) const { return m_id != other.m_id; }
+		bool operator > (const Entity& other) const { return m_id > other.m_id; }
+		bool operator < (const Entity& other) const { return m_id < other.m_id; }
+	};
+}
@@ -0,0 +1,57 @@
+#include "EngineFramework/ECS/EntityCommandBuffer.h"
+#include "EngineFramework/ECS/ECS.h"
+#include <algorithm>
+
+namespace AlphaEngine
+{
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		Clear();
+		for (Block& block : m_Blocks) {
+			::operator delete(block.memory, std::align_val_t(BLOCK_ALIGNMENT));
+		}
+	}
+
+	void* EntityCommandBuffer::Allocate(size_t size, size_t alignment)
+	{
+		// Try the current block, then the next one we kept from an earlier frame
+		while (m_CurrentBlock < m_Blocks.size()) {
+			Block& block = m_Blocks[m_CurrentBlock];
+			const size_t offset = (block.used + alignment - 1) & ~(alignment - 1);
+			if (offset + size <= block.size) {
+				block.used = offset + size;
+				return block.memory + offset;
+			}
+			m_CurrentBlock++;
+		}
+
+		// Big components get a block of their own size
+		Block block;
+		block.size = std::max(BLOCK_SIZE, size);
+		block.memory = static_cast<std::byte*>(::operator new(block.size, std::align_val_t(BLOCK_ALIGNMENT)));
+		block.used = size;
+		m_Blocks.push_back(block);
+		m_CurrentBlock = m_Blocks.size() - 1;
+		return block.memory;
+	}
+
+	Entity EntityCommandBuffer::CreateEntity()
+	{
+		const Entity entity = m_Owner.ReserveEntity();
+		Record(CommandType::Create, entity);
+		return entity;
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		for (Command& command : m_Commands) {
+			if (command.destroyPayload) command.destroyPayload(command.payload);
+		}
+		m_Commands.clear();
+
+		for (Block& block : m_Blocks) {
+			block.used = 0;
+		}
+		m_CurrentBlock = 0;
+	}
+}
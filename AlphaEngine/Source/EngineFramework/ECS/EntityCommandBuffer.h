@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "EngineFramework/ECS/ECSTypes.h"
+
+namespace AlphaEngine
+{
+	class ECSOrchestrator;
+
+	// <-------------------------- Entity Command Buffer ----------------------------->
+	//
+	// CreateEntity/AddComponent/RemoveComponent/DestroyEntity touch the signatures, the pools and the
+	// pending lists without any lock, so they are main thread only.
+	// A job (or a Jolt contact callback) records what it wants to do in its OWN buffer instead:
+	//
+	// Worker 1 buffer | [Create e40] [Add Transform e40] [Destroy e7]
+	// Worker 2 buffer | [Add Velocity e3] [Create e41]
+	//
+	// and UpdateEntitiesLifeTime plays all the buffers back on the main thread in one batch.
+	// Creating only reserves the id (one atomic add), so the new Entity can be used right away in later commands.
+	//
+	// Get the buffer of the calling thread with ecs.GetCommandBuffer(), never share one between threads.
+	class EntityCommandBuffer
+	{
+	public:
+		enum class CommandType : uint8_t
+		{
+			Create,
+			AddComponent,
+			RemoveComponent,
+			Destroy
+		};
+
+		struct Command
+		{
+			CommandType type;
+			Entity entity;
+			// Recording order inside this buffer, keeps the commands of one entity in order after sorting
+			uint32_t sequence = 0;
+
+			// Add only: the component waiting in the arena and how to hand it to the orchestrator
+			void* payload = nullptr;
+			void (*apply)(ECSOrchestrator& ecs, Entity entity, void* payload) = nullptr;
+			void (*destroyPayload)(void* payload) = nullptr;
+		};
+
+	private:
+		// Payloads live in blocks that never move, a growing std::vector<std::byte> would memcpy
+		// components that can't be memcpy'd (std::string...)
+		struct Block
+		{
+			std::byte* memory = nullptr;
+			size_t size = 0;
+			size_t used = 0;
+		};
+
+		static constexpr size_t BLOCK_SIZE = 16 * 1024;
+		static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+		ECSOrchestrator& m_Owner;
+		std::vector<Command> m_Commands;
+
+		// Kept between frames, Clear() only rewinds them
+		std::vector<Block> m_Blocks;
+		size_t m_CurrentBlock = 0;
+
+		void* Allocate(size_t size, size_t alignment);
+
+		template <typename T>
+		static void ApplyAdd(ECSOrchestrator& ecs, Entity entity, void* payload);
+
+		template <typename T>
+		static void ApplyRemove(ECSOrchestrator& ecs, Entity entity, void* payload);
+
+		void Record(CommandType type, Entity entity, void* payload = nullptr,
+			void (*apply)(ECSOrchestrator&, Entity, void*) = nullptr, void (*destroyPayload)(void*) = nullptr)
+		{
+			Command command;
+			command.type = type;
+			command.entity = entity;
+			command.sequence = static_cast<uint32_t>(m_Commands.size());
+			command.payload = payload;
+			command.apply = apply;
+			command.destroyPayload = destroyPayload;
+			m_Commands.push_back(command);
+		}
+
+	public:
+		explicit EntityCommandBuffer(ECSOrchestrator& owner) : m_Owner(owner) { m_Commands.reserve(256); }
+		~EntityCommandBuffer();
+
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+		// The id is reserved now (lock free), the entity exists after the next UpdateEntitiesLifeTime
+		Entity CreateEntity();
+
+		template <typename T, typename ...TArgs>
+		void AddComponent(Entity entity, TArgs&& ...args)
+		{
+			static_assert(alignof(T) <= BLOCK_ALIGNMENT, "Component is aligned more than the command buffer blocks");
+
+			// A tag has nothing to carry
+			if constexpr (IsTagComponent<T>) {
+				Record(CommandType::AddComponent, entity, nullptr, &ApplyAdd<T>);
+			}
+			else {
+				void* payload = Allocate(sizeof(T), alignof(T));
+				new (payload) T(std::forward<TArgs>(args)...);
+				Record(CommandType::AddComponent, entity, payload, &ApplyAdd<T>, [](void* object) { static_cast<T*>(object)->~T(); });
+			}
+		}
+
+		template <typename T>
+		void RemoveComponent(Entity entity)
+		{
+			Record(CommandType::RemoveComponent, entity, nullptr, &ApplyRemove<T>);
+		}
+
+		void DestroyEntity(Entity entity) { Record(CommandType::Destroy, entity); }
+
+		inline bool IsEmpty() const { return m_Commands.empty(); }
+		inline size_t GetCommandCount() const { return m_Commands.size(); }
+		inline const std::vector<Command>& GetCommands() const { return m_Commands; }
+
+		// Drops every command (destroying the payloads that were never played back), keeps the memory
+		void Clear();
+	};
+}
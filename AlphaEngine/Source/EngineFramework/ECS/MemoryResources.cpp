@@ -0,0 +1,119 @@
+#include "EngineFramework/ECS/MemoryResources.h"
+#include "EngineFramework/Logger.h"
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace AlphaEngine
+{
+	// 2 MB is the large page size on x64 for both Windows and Linux
+	static constexpr size_t LARGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	static size_t RoundUp(size_t value, size_t multiple)
+	{
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+	LargePageArena::Block LargePageArena::AllocateBlock(size_t minimumSize)
+	{
+		Block block;
+		block.size = RoundUp(std::max(m_BlockSize, minimumSize), LARGE_PAGE_SIZE);
+
+#ifdef _WIN32
+		// Needs the "Lock pages in memory" privilege, most machines don't have it
+		const size_t largePageMinimum = GetLargePageMinimum();
+		if (largePageMinimum > 0) {
+			const size_t largeSize = RoundUp(block.size, largePageMinimum);
+			block.memory = static_cast<std::byte*>(VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+			if (block.memory) {
+				block.size = largeSize;
+				block.largePages = true;
+			}
+		}
+		if (!block.memory) {
+			block.memory = static_cast<std::byte*>(VirtualAlloc(nullptr, block.size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+		}
+#else
+		// Explicit huge pages only work if the admin reserved some, otherwise ask for transparent ones
+		void* memory = mmap(nullptr, block.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (memory != MAP_FAILED) {
+			block.largePages = true;
+		}
+		else {
+			memory = mmap(nullptr, block.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+				madvise(memory, block.size, MADV_HUGEPAGE);
+#endif
+			}
+			else {
+				memory = nullptr;
+			}
+		}
+		block.memory = static_cast<std::byte*>(memory);
+#endif
+
+		if (!block.memory) {
+			Logger::Err("LargePageArena: the OS refused a block of " + std::to_string(block.size / (1024 * 1024)) + " MB");
+			throw std::bad_alloc();
+		}
+		return block;
+	}
+
+	void LargePageArena::FreeBlock(Block& block)
+	{
+#ifdef _WIN32
+		VirtualFree(block.memory, 0, MEM_RELEASE);
+#else
+		munmap(block.memory, block.size);
+#endif
+		block.memory = nullptr;
+	}
+
+	void* LargePageArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		if (!m_Blocks.empty()) {
+			Block& block = m_Blocks.back();
+			const size_t offset = RoundUp(block.used, alignment);
+			if (offset + bytes <= block.size) {
+				block.used = offset + bytes;
+				m_UsedBytes += bytes;
+				return block.memory + offset;
+			}
+		}
+
+		// The blocks are page aligned, so a fresh one fits any alignment up to the page size
+		m_Blocks.push_back(AllocateBlock(bytes));
+		Block& block = m_Blocks.back();
+		block.used = bytes;
+		m_UsedBytes += bytes;
+		return block.memory;
+	}
+
+	void LargePageArena::Release()
+	{
+		for (Block& block : m_Blocks) {
+			FreeBlock(block);
+		}
+		m_Blocks.clear();
+		m_UsedBytes = 0;
+	}
+
+	size_t LargePageArena::GetReservedBytes() const
+	{
+		size_t reserved = 0;
+		for (const Block& block : m_Blocks) reserved += block.size;
+		return reserved;
+	}
+
+	bool LargePageArena::UsesLargePages() const
+	{
+		return std::any_of(m_Blocks.begin(), m_Blocks.end(), [](const Block& block) { return block.largePages; });
+	}
+}
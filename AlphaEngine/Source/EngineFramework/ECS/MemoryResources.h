@@ -0,0 +1,140 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace AlphaEngine
+{
+	// <-------------------------- ECS Memory Resources ----------------------------->
+	//
+	// Every ECS container (pool dense arrays, sparse pages, system entity lists, pending lists) is a std::pmr container,
+	// so where its memory comes from can be chosen per pool without changing a single line of the code that uses it:
+	//
+	// LargePageArena    -> level lifetime data (static scenery pools), bump allocation out of huge OS blocks,
+	//                      nothing is freed until Release() (level unload). Reserve the pools up front,
+	//                      a growing vector leaves its old buffer behind in the arena.
+	// ChurnPoolResource -> components that come and go all the time (projectiles, particles, hit markers),
+	//                      freed buffers go back to size class free lists and the next growth reuses them
+	//                      instead of going to the heap.
+	// nullptr           -> the default heap (std::pmr::get_default_resource()), same as before.
+	//
+	// None of them lock, and neither do the ECS structural changes: main thread only.
+	//
+	// Usage (before the pool of T is first used):
+	// ecs.SetComponentMemoryResource<ProjectileComponent>(&churnPool);
+
+	struct AllocationStats
+	{
+		// What the containers hold right now and the most they ever held
+		size_t bytesInUse = 0;
+		size_t peakBytes = 0;
+		// Every byte ever asked for, growth reallocations included
+		size_t totalBytesAllocated = 0;
+		uint64_t allocationCount = 0;
+		uint64_t deallocationCount = 0;
+	};
+
+	// Forwards to another resource and counts what goes through it.
+	// Every component pool allocates through its own one, that's where the per pool stats come from
+	class TrackingResource : public std::pmr::memory_resource
+	{
+	private:
+		std::pmr::memory_resource* m_Upstream;
+		AllocationStats m_Stats;
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			void* memory = m_Upstream->allocate(bytes, alignment);
+			m_Stats.bytesInUse += bytes;
+			m_Stats.peakBytes = std::max(m_Stats.peakBytes, m_Stats.bytesInUse);
+			m_Stats.totalBytesAllocated += bytes;
+			m_Stats.allocationCount++;
+			return memory;
+		}
+
+		void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+		{
+			m_Upstream->deallocate(memory, bytes, alignment);
+			m_Stats.bytesInUse -= bytes;
+			m_Stats.deallocationCount++;
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	public:
+		explicit TrackingResource(std::pmr::memory_resource* upstream = nullptr)
+			: m_Upstream(upstream ? upstream : std::pmr::get_default_resource()) {}
+
+		TrackingResource(const TrackingResource&) = delete;
+		TrackingResource& operator=(const TrackingResource&) = delete;
+
+		inline std::pmr::memory_resource* GetUpstream() const { return m_Upstream; }
+		inline const AllocationStats& GetStats() const { return m_Stats; }
+	};
+
+	// Monotonic arena carved out of large OS blocks, with huge pages when the OS gives us some
+	// (fewer TLB misses walking big pools). Falls back to normal pages silently.
+	class LargePageArena : public std::pmr::memory_resource
+	{
+	private:
+		struct Block
+		{
+			std::byte* memory = nullptr;
+			size_t size = 0;
+			size_t used = 0;
+			bool largePages = false;
+		};
+
+		std::vector<Block> m_Blocks;
+		size_t m_BlockSize;
+		size_t m_UsedBytes = 0;
+
+		Block AllocateBlock(size_t minimumSize);
+		static void FreeBlock(Block& block);
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		// Monotonic, the memory only comes back with Release()
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+		explicit LargePageArena(size_t blockSize = DEFAULT_BLOCK_SIZE) : m_BlockSize(blockSize) {}
+		~LargePageArena() override { Release(); }
+
+		LargePageArena(const LargePageArena&) = delete;
+		LargePageArena& operator=(const LargePageArena&) = delete;
+
+		// Gives every block back to the OS. Whatever was allocated from the arena is gone,
+		// so the pools using it must be destroyed (or Reset) first
+		void Release();
+
+		inline size_t GetUsedBytes() const { return m_UsedBytes; }
+		size_t GetReservedBytes() const;
+		bool UsesLargePages() const;
+	};
+
+	// Size class free lists (std::pmr::unsynchronized_pool_resource) tuned for the ECS containers:
+	// pool arrays grow by doubling, so big buffers are pooled too
+	class ChurnPoolResource : public std::pmr::unsynchronized_pool_resource
+	{
+	private:
+		static std::pmr::pool_options MakeOptions()
+		{
+			std::pmr::pool_options options;
+			options.max_blocks_per_chunk = 64;
+			options.largest_required_pool_block = 4 * 1024 * 1024;
+			return options;
+		}
+
+	public:
+		explicit ChurnPoolResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+			: std::pmr::unsynchronized_pool_resource(MakeOptions(), upstream) {}
+	};
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace AlphaEngine
+{
+	// <-------------------------- Paged Sparse Array ----------------------------->
+	//
+	// A plain std::vector<int> sparse array has to be as big as the highest entity index ever seen,
+	// even if the pool only holds 3 components. With 20 pools and 10 systems that is a lot of -1s.
+	// Instead we split it in pages of 4096 entries that are only allocated when something is written in them:
+	//
+	// Page table | [null] [page] [null] [null] [page]
+	//                        |                    |
+	//                  entities 4096..8191   entities 16384..20479
+	//
+	// Untouched pages all point to ONE shared, read only page full of -1, so a lookup never has to check
+	// for nullptr, it is always table[index >> 12][index & 4095].
+	// A page that becomes empty again is freed, so the memory follows how many entities are actually in there.
+	// The pages and the page table come from the memory resource it was built with (the default heap if none).
+	class PagedSparseArray
+	{
+	public:
+		static constexpr uint32_t PAGE_BITS = 12;
+		static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+		static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+		static constexpr int32_t EMPTY = -1;
+
+	private:
+		using Page = std::array<int32_t, PAGE_SIZE>;
+
+		static constexpr Page MakeNullPage()
+		{
+			Page page{};
+			for (auto& value : page) value = EMPTY;
+			return page;
+		}
+		inline static const Page s_NullPage = MakeNullPage();
+
+		std::pmr::memory_resource* m_Resource;
+		// Either &s_NullPage (never written to) or a page we own
+		std::pmr::vector<Page*> m_Pages;
+		// How many used entries every page has, so we know when to give it back
+		std::pmr::vector<uint16_t> m_PageCounts;
+		uint32_t m_AllocatedPages = 0;
+
+		static Page* NullPage() { return const_cast<Page*>(&s_NullPage); }
+
+		Page* AllocatePage()
+		{
+			void* memory = m_Resource->allocate(sizeof(Page), alignof(Page));
+			return new (memory) Page(s_NullPage);
+		}
+
+		void DeallocatePage(Page* page)
+		{
+			// Page is an array of ints, nothing to destroy
+			m_Resource->deallocate(page, sizeof(Page), alignof(Page));
+		}
+
+		void FreePage(uint32_t page)
+		{
+			DeallocatePage(m_Pages[page]);
+			m_Pages[page] = NullPage();
+			m_AllocatedPages--;
+		}
+
+	public:
+		explicit PagedSparseArray(std::pmr::memory_resource* resource = nullptr)
+			: m_Resource(resource ? resource : std::pmr::get_default_resource()), m_Pages(m_Resource), m_PageCounts(m_Resource) {}
+		~PagedSparseArray() { Clear(); }
+
+		PagedSparseArray(const PagedSparseArray&) = delete;
+		PagedSparseArray& operator=(const PagedSparseArray&) = delete;
+
+		// The pmr vectors keep the allocator they were moved from, so the pages stay with their resource
+		PagedSparseArray(PagedSparseArray&& other) noexcept
+			: m_Resource(other.m_Resource), m_Pages(std::move(other.m_Pages)), m_PageCounts(std::move(other.m_PageCounts)), m_AllocatedPages(other.m_AllocatedPages)
+		{
+			other.m_AllocatedPages = 0;
+		}
+
+		// Takes over the other array's resource too (a pmr vector can't change its allocator by assignment,
+		// so we rebuild in place)
+		PagedSparseArray& operator=(PagedSparseArray&& other) noexcept
+		{
+			if (this != &other) {
+				std::destroy_at(this);
+				std::construct_at(this, std::move(other));
+			}
+			return *this;
+		}
+
+		inline std::pmr::memory_resource* GetMemoryResource() const { return m_Resource; }
+
+		// EMPTY when nothing was stored for that index
+		inline int32_t Get(uint32_t index) const
+		{
+			const uint32_t page = index >> PAGE_BITS;
+			if (page >= m_Pages.size()) return EMPTY;
+			return (*m_Pages[page])[index & PAGE_MASK];
+		}
+
+		inline bool Contains(uint32_t index) const { return Get(index) != EMPTY; }
+
+		// Only valid for an index that Contains() (no bounds check), used on the hot paths
+		inline int32_t GetUnchecked(uint32_t index) const
+		{
+			return (*m_Pages[index >> PAGE_BITS])[index & PAGE_MASK];
+		}
+
+		// Grows the page table (not the pages) so the indices up to maxIndex can be looked up
+		void Reserve(uint32_t maxIndex)
+		{
+			const uint32_t pageCount = (maxIndex >> PAGE_BITS) + 1;
+			if (pageCount > m_Pages.size()) {
+				m_Pages.resize(pageCount, NullPage());
+				m_PageCounts.resize(pageCount, 0);
+			}
+		}
+
+		void Set(uint32_t index, int32_t value)
+		{
+			assert(value != EMPTY && "Use Remove() to clear an entry");
+
+			const uint32_t page = index >> PAGE_BITS;
+			Reserve(index);
+
+			if (m_Pages[page] == NullPage()) {
+				m_Pages[page] = AllocatePage();
+				m_AllocatedPages++;
+			}
+
+			int32_t& slot = (*m_Pages[page])[index & PAGE_MASK];
+			if (slot == EMPTY) m_PageCounts[page]++;
+			slot = value;
+		}
+
+		void Remove(uint32_t index)
+		{
+			const uint32_t page = index >> PAGE_BITS;
+			if (page >= m_Pages.size() || m_Pages[page] == NullPage()) return;
+
+			int32_t& slot = (*m_Pages[page])[index & PAGE_MASK];
+			if (slot == EMPTY) return;
+
+			slot = EMPTY;
+			if (--m_PageCounts[page] == 0) {
+				FreePage(page);
+			}
+		}
+
+		void Clear()
+		{
+			for (uint32_t page = 0; page < m_Pages.size(); ++page) {
+				if (m_Pages[page] != NullPage()) {
+					DeallocatePage(m_Pages[page]);
+				}
+			}
+			m_Pages.clear();
+			m_PageCounts.clear();
+			m_AllocatedPages = 0;
+		}
+
+		inline uint32_t GetAllocatedPageCount() const { return m_AllocatedPages; }
+
+		// What this array actually costs (the pages plus the page table)
+		inline size_t GetMemoryUsage() const
+		{
+			return m_AllocatedPages * sizeof(Page) + m_Pages.capacity() * sizeof(Page*) + m_PageCounts.capacity() * sizeof(uint16_t);
+		}
+	};
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "EngineFramework/ECS/ECSTypes.h"
+
+namespace AlphaEngine
+{
+	class ECSOrchestrator;
+
+	// <-------------------------- Prefabs ----------------------------->
+	//
+	// A template entity: a signature plus one value per component, built once and cloned as many times as needed.
+	// Building 1000 balls by hand means 1000 rounds of "construct the component, find its pool, push it" per component.
+	// ecs.Instantiate(prefab, 1000) does instead:
+	//
+	// Transform pool | ... [copy x 1000]    <- one reserve, one loop copying the same value
+	// Render pool    | ... [copy x 1000]
+	// Signatures     | prefab signature x 1000
+	// Systems        | all 1000 matched together in the next UpdateEntitiesLifeTime
+	//
+	// Prefab ball;
+	// ball.Add<TransformComponent>(glm::vec3(0.0f), glm::vec3(0.2f)).Add<RenderComponent>(mesh, shader, texture).Add<IsBall>();
+	// std::vector<Entity> balls = ecs.Instantiate(ball, 20, std::span(ballTransforms));
+	//
+	// Components with external resources (RigidBodyComponent) are cloned as they are, the owner of the resource
+	// creates it afterwards for the whole batch (PhysicsSystem::CreateBodies).
+	class Prefab
+	{
+	private:
+		// Copies the stored value into the pool (or archetype rows) of every entity
+		using CloneFn = void (*)(ECSOrchestrator& ecs, std::span<const Entity> entities, const void* value, uint32_t tick);
+		using DeleteFn = void (*)(void* value);
+
+		struct Entry
+		{
+			uint16_t componentId = 0;
+			std::unique_ptr<void, DeleteFn> value{ nullptr, nullptr };
+			CloneFn clone = nullptr;
+		};
+
+		// Tags included, they only live here
+		Signature m_Signature;
+		// One per non tag component
+		std::vector<Entry> m_Entries;
+
+		// Defined in ECS.h, it needs the whole orchestrator
+		template <typename T>
+		static void CloneInto(ECSOrchestrator& ecs, std::span<const Entity> entities, const void* value, uint32_t tick);
+
+		Entry* FindEntry(uint16_t componentId)
+		{
+			for (Entry& entry : m_Entries) {
+				if (entry.componentId == componentId) return &entry;
+			}
+			return nullptr;
+		}
+
+		const Entry* FindEntry(uint16_t componentId) const { return const_cast<Prefab*>(this)->FindEntry(componentId); }
+
+		friend class ECSOrchestrator;
+
+	public:
+		Prefab() = default;
+
+		// Move only, the values are owned
+		Prefab(const Prefab&) = delete;
+		Prefab& operator=(const Prefab&) = delete;
+		Prefab(Prefab&&) = default;
+		Prefab& operator=(Prefab&&) = default;
+
+		// Adds (or replaces) the value every clone of T starts with
+		template <typename T, typename ...TArgs>
+		Prefab& Add(TArgs&& ...args)
+		{
+			const uint16_t componentId = static_cast<uint16_t>(Component<T>::GetId());
+			m_Signature.set(componentId);
+
+			if constexpr (!IsTagComponent<T>) {
+				Entry entry;
+				entry.componentId = componentId;
+				entry.value = std::unique_ptr<void, DeleteFn>(new T(std::forward<TArgs>(args)...), [](void* value) { delete static_cast<T*>(value); });
+				entry.clone = &CloneInto<T>;
+
+				if (Entry* existing = FindEntry(componentId)) {
+					*existing = std::move(entry);
+				}
+				else {
+					m_Entries.push_back(std::move(entry));
+				}
+			}
+			return *this;
+		}
+
+		template <typename T>
+		void Remove()
+		{
+			const uint16_t componentId = static_cast<uint16_t>(Component<T>::GetId());
+			m_Signature.set(componentId, false);
+			std::erase_if(m_Entries, [componentId](const Entry& entry) { return entry.componentId == componentId; });
+		}
+
+		template <typename T>
+		bool Has() const { return m_Signature.test(Component<T>::GetId()); }
+
+		// The value the next clones start with, can be tweaked between Instantiate calls
+		template <typename T>
+		T& Get()
+		{
+			static_assert(!IsTagComponent<T>, "Tags have no data to get, use Has<T>()");
+			Entry* entry = FindEntry(static_cast<uint16_t>(Component<T>::GetId()));
+			assert(entry && "The prefab doesn't have this component!");
+			return *static_cast<T*>(entry->value.get());
+		}
+
+		inline const Signature& GetSignature() const { return m_Signature; }
+	};
+}
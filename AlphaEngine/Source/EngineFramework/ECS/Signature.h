@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <bit>
+#include <functional>
+
+// How many component types a world can have, set from CMake (ALPHA_MAX_COMPONENTS).
+// Every entity carries one Signature, so this is paid per entity: up to 64 -> 8 bytes, 128 -> 16, 256 -> 32
+#ifndef ALPHA_MAX_COMPONENTS
+#define ALPHA_MAX_COMPONENTS 64
+#endif
+
+namespace AlphaEngine
+{
+	const uint16_t MAX_COMPONENTS = ALPHA_MAX_COMPONENTS;
+	static_assert(MAX_COMPONENTS > 0 && MAX_COMPONENTS <= 256, "ALPHA_MAX_COMPONENTS must be between 1 and 256");
+
+	// Signature: We use a bitset (1s and 0s) to keep track of which
+	// components an entity has, and also helps keep track of which
+	// entities a system is interested in.
+	//
+	// Our own instead of std::bitset so the layout is known: plain 64 bit words, bit i of the set is bit (i % 64) of word (i / 64).
+	// That's what lets the SIMD kernels in SignatureMatch.h run over a contiguous array of them,
+	// and ForEachComponent walk the words instead of testing every bit.
+	// The word count is a power of two (1, 2 or 4) so a whole number of signatures fits in a SIMD register
+	class Signature
+	{
+	public:
+		static constexpr uint32_t WordCount = MAX_COMPONENTS <= 64 ? 1 : (MAX_COMPONENTS <= 128 ? 2 : 4);
+
+	private:
+		uint64_t m_Words[WordCount] = {};
+
+		// The word holding bit MAX_COMPONENTS - 1. Not always the last one: WordCount is rounded up to a power of two,
+		// so 129 to 192 components still take 4 words and the words after this one are padding
+		static constexpr uint32_t LastUsedWord = (MAX_COMPONENTS - 1) / 64;
+		// The bits above MAX_COMPONENTS in that word, operator~ must keep them (and the padding words) 0
+		static constexpr uint64_t LastWordMask = (MAX_COMPONENTS % 64) == 0 ? ~0ull : (1ull << (MAX_COMPONENTS % 64)) - 1;
+
+	public:
+		constexpr Signature() = default;
+
+		inline Signature& set(size_t bit)
+		{
+			assert(bit < MAX_COMPONENTS);
+			m_Words[bit / 64] |= 1ull << (bit % 64);
+			return *this;
+		}
+
+		inline Signature& set(size_t bit, bool value)
+		{
+			return value ? set(bit) : reset(bit);
+		}
+
+		inline Signature& reset(size_t bit)
+		{
+			assert(bit < MAX_COMPONENTS);
+			m_Words[bit / 64] &= ~(1ull << (bit % 64));
+			return *this;
+		}
+
+		inline Signature& reset()
+		{
+			for (uint64_t& word : m_Words) word = 0;
+			return *this;
+		}
+
+		inline bool test(size_t bit) const
+		{
+			assert(bit < MAX_COMPONENTS);
+			return (m_Words[bit / 64] >> (bit % 64)) & 1;
+		}
+
+		inline bool operator [] (size_t bit) const { return test(bit); }
+
+		inline bool any() const
+		{
+			uint64_t combined = 0;
+			for (uint64_t word : m_Words) combined |= word;
+			return combined != 0;
+		}
+
+		inline bool none() const { return !any(); }
+
+		inline size_t count() const
+		{
+			size_t bits = 0;
+			for (uint64_t word : m_Words) bits += std::popcount(word);
+			return bits;
+		}
+
+		static constexpr size_t size() { return MAX_COMPONENTS; }
+
+		// Has every bit of 'required', the test behind every system and view match.
+		// Same as (*this & required) == required without building the temporary
+		inline bool Contains(const Signature& required) const
+		{
+			uint64_t missing = 0;
+			for (uint32_t i = 0; i < WordCount; ++i) missing |= required.m_Words[i] & ~m_Words[i];
+			return missing == 0;
+		}
+
+		inline uint64_t GetWord(uint32_t index) const { return m_Words[index]; }
+		inline const uint64_t* GetWords() const { return m_Words; }
+
+		inline Signature& operator &= (const Signature& other)
+		{
+			for (uint32_t i = 0; i < WordCount; ++i) m_Words[i] &= other.m_Words[i];
+			return *this;
+		}
+
+		inline Signature& operator |= (const Signature& other)
+		{
+			for (uint32_t i = 0; i < WordCount; ++i) m_Words[i] |= other.m_Words[i];
+			return *this;
+		}
+
+		inline Signature& operator ^= (const Signature& other)
+		{
+			for (uint32_t i = 0; i < WordCount; ++i) m_Words[i] ^= other.m_Words[i];
+			return *this;
+		}
+
+		inline Signature operator ~ () const
+		{
+			Signature result;
+			for (uint32_t i = 0; i <= LastUsedWord; ++i) result.m_Words[i] = ~m_Words[i];
+			result.m_Words[LastUsedWord] &= LastWordMask;
+			return result;
+		}
+
+		friend inline Signature operator & (Signature left, const Signature& right) { return left &= right; }
+		friend inline Signature operator | (Signature left, const Signature& right) { return left |= right; }
+		friend inline Signature operator ^ (Signature left, const Signature& right) { return left ^= right; }
+
+		friend inline bool operator == (const Signature& left, const Signature& right)
+		{
+			uint64_t difference = 0;
+			for (uint32_t i = 0; i < WordCount; ++i) difference |= left.m_Words[i] ^ right.m_Words[i];
+			return difference == 0;
+		}
+	};
+
+	static_assert(sizeof(Signature) == Signature::WordCount * sizeof(uint64_t), "The SIMD kernels read signatures as a flat array of words");
+
+	// Calls f(componentId) for every component in the signature, lowest id first.
+	// Jumps straight from one set bit to the next instead of testing all MAX_COMPONENTS bits
+	template <typename F>
+	inline void ForEachComponent(const Signature& signature, F&& f)
+	{
+		for (uint32_t wordIndex = 0; wordIndex < Signature::WordCount; ++wordIndex) {
+			uint64_t bits = signature.GetWord(wordIndex);
+			while (bits != 0) {
+				f(static_cast<uint16_t>(wordIndex * 64 + std::countr_zero(bits)));
+				bits &= bits - 1;
+			}
+		}
+	}
+}
+
+// So a Signature can key an unordered_map (the archetype lookup)
+template <>
+struct std::hash<AlphaEngine::Signature>
+{
+	size_t operator()(const AlphaEngine::Signature& signature) const noexcept
+	{
+		uint64_t hash = 0;
+		for (uint32_t i = 0; i < AlphaEngine::Signature::WordCount; ++i) {
+			hash = (hash ^ signature.GetWord(i)) * 0x9E3779B97F4A7C15ull;
+		}
+		return static_cast<size_t>(hash ^ (hash >> 32));
+	}
+};
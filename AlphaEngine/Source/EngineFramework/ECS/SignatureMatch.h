@@ -0,0 +1,154 @@
+#pragma once
+
+#include "EngineFramework/ECS/Signature.h"
+#include <cstdint>
+#include <cstddef>
+
+// The kernel is picked at compile time, the engine is built for one instruction set:
+// AVX2 -> ALPHA_ENABLE_AVX2 in CMake (-mavx2 or /arch:AVX2), SSE2 -> every other x64 build, scalar -> everything else.
+// The ECS only calls it in AVX2 builds (UseKernel below), the SSE2 and scalar kernels are there for the bench
+#if defined(__AVX2__)
+#define ALPHA_SIGNATURE_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ALPHA_SIGNATURE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AlphaEngine
+{
+	// Matching one signature against many (systems against a new entity, a query against every archetype).
+	// Written against a contiguous array of Signatures so the words can be loaded 4 at a time:
+	//
+	// 1 word  per signature -> 4 signatures per 256 bits
+	// 2 words per signature -> 2
+	// 4 words per signature -> 1 (MAX_COMPONENTS = 256)
+	//
+	// A word "passes" when (required & ~have) == 0, a signature matches when all of its words pass.
+	// Compare it against the plain Signature::Contains loop with the signature.* cases of AlphaEngineBench
+	namespace SignatureMatch
+	{
+		inline const char* GetKernelName()
+		{
+#if defined(ALPHA_SIGNATURE_AVX2)
+			return "avx2";
+#elif defined(ALPHA_SIGNATURE_SSE2)
+			return "sse2";
+#else
+			return "scalar";
+#endif
+		}
+
+		// Whether ForEachSignatureContaining/ContainedIn go through the kernel below or a plain Contains loop.
+		// Only AVX2 beat the loop in AlphaEngineBench: with SSE2 the 64 bit compare has to be emulated
+		// and the compiler already vectorizes the loop about as well (compare them with --filter signature)
+#if defined(ALPHA_SIGNATURE_AVX2)
+		constexpr bool UseKernel = true;
+#else
+		constexpr bool UseKernel = false;
+#endif
+
+		constexpr uint32_t WordsPerBlock = 4;
+		constexpr uint32_t SignaturesPerBlock = WordsPerBlock / Signature::WordCount;
+
+		// One bit per word of the block (bit i = word i passed).
+		// ArrayIsRequired = false -> the array has what the entities have, 'pattern' is what is required
+		// ArrayIsRequired = true  -> the array has what the systems require, 'pattern' is what the entity has
+		template <bool ArrayIsRequired>
+		inline uint32_t PassingWords(const uint64_t* block, const uint64_t* pattern)
+		{
+#if defined(ALPHA_SIGNATURE_AVX2)
+			const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+			const __m256i other = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern));
+			// andnot(a, b) = ~a & b -> the required bits that are missing
+			const __m256i missing = ArrayIsRequired ? _mm256_andnot_si256(other, words) : _mm256_andnot_si256(words, other);
+			const __m256i passed = _mm256_cmpeq_epi64(missing, _mm256_setzero_si256());
+			return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(passed)));
+#elif defined(ALPHA_SIGNATURE_SSE2)
+			// No 64 bit compare before SSE4.1, compare the 32 bit halves and read one mask bit per byte instead
+			uint32_t result = 0;
+			for (uint32_t half = 0; half < 2; ++half) {
+				const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + half * 2));
+				const __m128i other = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + half * 2));
+				const __m128i missing = ArrayIsRequired ? _mm_andnot_si128(other, words) : _mm_andnot_si128(words, other);
+				const uint32_t bytes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(missing, _mm_setzero_si128())));
+				result |= ((bytes & 0x00FF) == 0x00FF ? 1u : 0u) << (half * 2);
+				result |= ((bytes & 0xFF00) == 0xFF00 ? 2u : 0u) << (half * 2);
+			}
+			return result;
+#else
+			uint32_t result = 0;
+			for (uint32_t i = 0; i < WordsPerBlock; ++i) {
+				const uint64_t missing = ArrayIsRequired ? block[i] & ~pattern[i] : pattern[i] & ~block[i];
+				result |= (missing == 0 ? 1u : 0u) << i;
+			}
+			return result;
+#endif
+		}
+
+		// Word bits -> signature bits (bit i = signature i of the block matched)
+		inline uint32_t MatchingSignatures(uint32_t wordBits)
+		{
+			if constexpr (Signature::WordCount == 1) {
+				return wordBits;
+			}
+			else if constexpr (Signature::WordCount == 2) {
+				const uint32_t pairs = wordBits & (wordBits >> 1);
+				return (pairs & 1) | ((pairs >> 1) & 2);
+			}
+			else {
+				return wordBits == 0xF ? 1u : 0u;
+			}
+		}
+
+		template <bool ArrayIsRequired, typename F>
+		inline void ForEachMatchScalar(const Signature* signatures, size_t begin, size_t end, const Signature& other, F&& f)
+		{
+			for (size_t i = begin; i < end; ++i) {
+				const bool match = ArrayIsRequired ? other.Contains(signatures[i]) : signatures[i].Contains(other);
+				if (match) f(i);
+			}
+		}
+
+		// The kernel itself, always the SIMD one (the bench calls it directly to compare it with the loop)
+		template <bool ArrayIsRequired, typename F>
+		inline void ForEachMatch(const Signature* signatures, size_t count, const Signature& other, F&& f)
+		{
+			// 'other' repeated until it fills a block
+			uint64_t pattern[WordsPerBlock];
+			for (uint32_t i = 0; i < WordsPerBlock; ++i) pattern[i] = other.GetWord(i % Signature::WordCount);
+
+			const uint64_t* words = reinterpret_cast<const uint64_t*>(signatures);
+			const size_t fullBlocks = count / SignaturesPerBlock;
+
+			for (size_t block = 0; block < fullBlocks; ++block) {
+				uint32_t matches = MatchingSignatures(PassingWords<ArrayIsRequired>(words + block * WordsPerBlock, pattern));
+				while (matches != 0) {
+					f(block * SignaturesPerBlock + std::countr_zero(matches));
+					matches &= matches - 1;
+				}
+			}
+
+			// The last few that don't fill a block
+			ForEachMatchScalar<ArrayIsRequired>(signatures, fullBlocks * SignaturesPerBlock, count, other, f);
+		}
+	}
+
+	// Calls f(index) for every signatures[index] that has all the bits of 'required', lowest index first.
+	// e.g. the archetypes a View<Ts...> has to walk
+	template <typename F>
+	inline void ForEachSignatureContaining(const Signature* signatures, size_t count, const Signature& required, F&& f)
+	{
+		if constexpr (SignatureMatch::UseKernel) SignatureMatch::ForEachMatch<false>(signatures, count, required, f);
+		else SignatureMatch::ForEachMatchScalar<false>(signatures, 0, count, required, f);
+	}
+
+	// Calls f(index) for every requiredSignatures[index] that 'signature' has all the bits of, lowest index first.
+	// e.g. which systems a new entity belongs to
+	template <typename F>
+	inline void ForEachSignatureContainedIn(const Signature* requiredSignatures, size_t count, const Signature& signature, F&& f)
+	{
+		if constexpr (SignatureMatch::UseKernel) SignatureMatch::ForEachMatch<true>(requiredSignatures, count, signature, f);
+		else SignatureMatch::ForEachMatchScalar<true>(requiredSignatures, 0, count, signature, f);
+	}
+}
@@ -0,0 +1,218 @@
+#include "EngineFramework/ECS/SystemScheduler.h"
+#include "EngineFramework/Logger.h"
+#include <algorithm>
+#include <format>
+
+namespace AlphaEngine
+{
+	static float MillisecondsSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+	{
+		return std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	SystemScheduler::SystemScheduler(uint32_t workerCount)
+	{
+		m_Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i) {
+			m_Workers.emplace_back(&SystemScheduler::WorkerLoop, this, i + 1);
+		}
+	}
+
+	SystemScheduler::~SystemScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_StopWorkers = true;
+		}
+		m_WorkerCondition.notify_all();
+
+		for (auto& worker : m_Workers) {
+			worker.join();
+		}
+	}
+
+	uint32_t SystemScheduler::DefaultWorkerCount()
+	{
+		const uint32_t cores = std::thread::hardware_concurrency();
+		return std::max(1u, cores / 2);
+	}
+
+	void SystemScheduler::AddJob(std::string name, const Signature& readSignature, const Signature& writeSignature, bool mainThreadOnly, std::function<void()> work)
+	{
+		Job job;
+		job.name = std::move(name);
+		job.readSignature = readSignature;
+		job.writeSignature = writeSignature;
+		job.mainThreadOnly = mainThreadOnly || m_Workers.empty();
+		job.work = std::move(work);
+		m_Jobs.push_back(std::move(job));
+	}
+
+	// Read/Read is fine, anything involving a Write on the same component is not
+	bool SystemScheduler::Conflicts(const Job& earlier, const Job& later)
+	{
+		return (earlier.writeSignature & (later.readSignature | later.writeSignature)).any() ||
+			(later.writeSignature & earlier.readSignature).any();
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		// A handful of systems per frame, so the O(n^2) pass is nothing compared to running them
+		for (uint32_t later = 0; later < m_Jobs.size(); ++later) {
+			for (uint32_t earlier = 0; earlier < later; ++earlier) {
+				if (Conflicts(m_Jobs[earlier], m_Jobs[later])) {
+					m_Jobs[earlier].dependents.push_back(later);
+					m_Jobs[later].dependencies.push_back(earlier);
+				}
+			}
+			m_Jobs[later].unfinishedDependencies = static_cast<uint32_t>(m_Jobs[later].dependencies.size());
+		}
+	}
+
+	void SystemScheduler::ExecuteJob(uint32_t jobIndex, uint32_t threadIndex)
+	{
+		Job& job = m_Jobs[jobIndex];
+
+		const auto start = std::chrono::steady_clock::now();
+		job.work();
+		const auto end = std::chrono::steady_clock::now();
+
+		job.timing.startMs = MillisecondsSince(m_FrameStart, start);
+		job.timing.durationMs = MillisecondsSince(start, end);
+		job.timing.threadIndex = threadIndex;
+
+		// Release everything that was waiting on us
+		uint32_t wokenWorkerJobs = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (uint32_t dependent : job.dependents) {
+				Job& next = m_Jobs[dependent];
+				if (--next.unfinishedDependencies == 0) {
+					if (next.mainThreadOnly) {
+						m_ReadyMainThreadJobs.push_back(dependent);
+					}
+					else {
+						m_ReadyWorkerJobs.push_back(dependent);
+						wokenWorkerJobs++;
+					}
+				}
+			}
+			m_JobsLeft--;
+		}
+
+		// The main thread is waiting for the last job, a main thread job or anything it can help with
+		for (uint32_t i = 0; i < wokenWorkerJobs; ++i) m_WorkerCondition.notify_one();
+		m_MainThreadCondition.notify_one();
+	}
+
+	void SystemScheduler::WorkerLoop(uint32_t threadIndex)
+	{
+		while (true) {
+			uint32_t jobIndex;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WorkerCondition.wait(lock, [this]() { return m_StopWorkers || !m_ReadyWorkerJobs.empty(); });
+				if (m_StopWorkers) return;
+
+				jobIndex = m_ReadyWorkerJobs.front();
+				m_ReadyWorkerJobs.pop_front();
+			}
+			ExecuteJob(jobIndex, threadIndex);
+		}
+	}
+
+	void SystemScheduler::Run()
+	{
+		if (m_Jobs.empty()) {
+			m_LastFrameTimings.clear();
+			m_LastFrameStats = SchedulerFrameStats();
+			return;
+		}
+
+		m_FrameStart = std::chrono::steady_clock::now();
+		BuildGraph();
+
+		uint32_t wokenWorkerJobs = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_JobsLeft = static_cast<uint32_t>(m_Jobs.size());
+
+			for (uint32_t i = 0; i < m_Jobs.size(); ++i) {
+				if (m_Jobs[i].unfinishedDependencies != 0) continue;
+
+				if (m_Jobs[i].mainThreadOnly) {
+					m_ReadyMainThreadJobs.push_back(i);
+				}
+				else {
+					m_ReadyWorkerJobs.push_back(i);
+					wokenWorkerJobs++;
+				}
+			}
+		}
+		for (uint32_t i = 0; i < wokenWorkerJobs; ++i) m_WorkerCondition.notify_one();
+
+		// The main thread doesn't just sit there, it runs its own jobs and steals worker jobs
+		while (true) {
+			uint32_t jobIndex;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_MainThreadCondition.wait(lock, [this]() {
+					return m_JobsLeft == 0 || !m_ReadyMainThreadJobs.empty() || !m_ReadyWorkerJobs.empty();
+					});
+
+				if (m_JobsLeft == 0) break;
+
+				if (!m_ReadyMainThreadJobs.empty()) {
+					jobIndex = m_ReadyMainThreadJobs.front();
+					m_ReadyMainThreadJobs.pop_front();
+				}
+				else {
+					jobIndex = m_ReadyWorkerJobs.front();
+					m_ReadyWorkerJobs.pop_front();
+				}
+			}
+			ExecuteJob(jobIndex, 0);
+		}
+
+		CollectStats(MillisecondsSince(m_FrameStart, std::chrono::steady_clock::now()));
+		m_Jobs.clear();
+	}
+
+	void SystemScheduler::CollectStats(float wallMs)
+	{
+		m_LastFrameTimings.clear();
+		m_LastFrameStats = SchedulerFrameStats();
+		m_LastFrameStats.wallMs = wallMs;
+		m_LastFrameStats.jobCount = static_cast<uint32_t>(m_Jobs.size());
+
+		// Jobs only depend on earlier jobs, so registration order is already a topological order
+		for (Job& job : m_Jobs) {
+			float longestDependency = 0.0f;
+			for (uint32_t dependency : job.dependencies) {
+				longestDependency = std::max(longestDependency, m_Jobs[dependency].timing.criticalFinishMs);
+			}
+			job.timing.criticalFinishMs = longestDependency + job.timing.durationMs;
+			job.timing.name = job.name;
+
+			m_LastFrameStats.totalWorkMs += job.timing.durationMs;
+			m_LastFrameStats.criticalPathMs = std::max(m_LastFrameStats.criticalPathMs, job.timing.criticalFinishMs);
+			m_LastFrameTimings.push_back(job.timing);
+		}
+
+		if (wallMs > 0.0f) {
+			m_LastFrameStats.parallelism = m_LastFrameStats.totalWorkMs / wallMs;
+		}
+	}
+
+	void SystemScheduler::LogLastFrame() const
+	{
+		const SchedulerFrameStats& stats = m_LastFrameStats;
+		Logger::Log(std::format("[Scheduler] {} jobs | wall {:.3f}ms | work {:.3f}ms | critical path {:.3f}ms | parallelism {:.2f}x | workers {}",
+			stats.jobCount, stats.wallMs, stats.totalWorkMs, stats.criticalPathMs, stats.parallelism, m_Workers.size()));
+
+		for (const auto& timing : m_LastFrameTimings) {
+			Logger::Log(std::format("[Scheduler]   {} | thread {} | start {:.3f}ms | took {:.3f}ms",
+				timing.name, timing.threadIndex, timing.startMs, timing.durationMs));
+		}
+	}
+}
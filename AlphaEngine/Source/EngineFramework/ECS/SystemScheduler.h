@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include "EngineFramework/ECS/ECSTypes.h"
+
+namespace AlphaEngine
+{
+	// <-------------------------- System Scheduler ----------------------------->
+	//
+	// Calling every system one after another on the main thread leaves the other cores idle.
+	// Every system declares which components it Reads and which it Writes, so two systems
+	// that don't touch the same data in a conflicting way can run at the same time:
+	//
+	// Transform (reads Transform, writes WorldTransform) ---+---> Camera      (reads WorldTransform, writes Camera)
+	//                                                      +---> SpatialGrid (reads WorldTransform, writes its own grid)
+	//
+	// Camera and SpatialGrid share nothing they write -> parallel
+	// Transform writes WorldTransform which both read -> they wait for Transform
+	//
+	// Each frame the jobs are added in the order we would have called them, and a job only
+	// depends on EARLIER jobs it conflicts with, so the result is the same as running them in order.
+	//
+	// IMPORTANT: Systems running on a worker must not create/destroy entities or add/remove components directly,
+	// those touch the shared signatures and pending lists. Record them in ecs.GetCommandBuffer() instead
+	// (played back in UpdateEntitiesLifeTime). Systems that need OpenGL, Jolt or the EventBus stay on the main thread.
+
+	// What a single job did during the last frame (all times in milliseconds from the start of Run())
+	struct ScheduledJobTiming
+	{
+		std::string name;
+		float startMs = 0.0f;
+		float durationMs = 0.0f;
+		// 0 = main thread, 1..N = worker
+		uint32_t threadIndex = 0;
+		// Earliest this job could have finished with infinite cores (longest chain of dependencies ending here)
+		float criticalFinishMs = 0.0f;
+	};
+
+	struct SchedulerFrameStats
+	{
+		// How long Run() took on the main thread
+		float wallMs = 0.0f;
+		// Sum of all the job durations, what running them one after another would cost
+		float totalWorkMs = 0.0f;
+		// Longest chain of dependent jobs, no amount of cores makes the frame shorter than this
+		float criticalPathMs = 0.0f;
+		// totalWork / wall -> 1.0 means everything ran serially
+		float parallelism = 1.0f;
+		uint32_t jobCount = 0;
+	};
+
+	class SystemScheduler
+	{
+	private:
+		struct Job
+		{
+			std::string name;
+			Signature readSignature;
+			Signature writeSignature;
+			bool mainThreadOnly = false;
+			std::function<void()> work;
+
+			// DAG edges, jobs that have to wait for this one
+			std::vector<uint32_t> dependents;
+			// Jobs this one waits for (used for the critical path)
+			std::vector<uint32_t> dependencies;
+			uint32_t unfinishedDependencies = 0;
+
+			ScheduledJobTiming timing;
+		};
+
+		std::vector<Job> m_Jobs;
+
+		// Ready to run, split by who is allowed to run them
+		std::deque<uint32_t> m_ReadyWorkerJobs;
+		std::deque<uint32_t> m_ReadyMainThreadJobs;
+		uint32_t m_JobsLeft = 0;
+
+		std::vector<std::thread> m_Workers;
+		std::mutex m_Mutex;
+		std::condition_variable m_WorkerCondition;
+		std::condition_variable m_MainThreadCondition;
+		bool m_StopWorkers = false;
+
+		std::chrono::steady_clock::time_point m_FrameStart;
+
+		std::vector<ScheduledJobTiming> m_LastFrameTimings;
+		SchedulerFrameStats m_LastFrameStats;
+
+		static bool Conflicts(const Job& earlier, const Job& later);
+
+		void BuildGraph();
+		void WorkerLoop(uint32_t threadIndex);
+		void ExecuteJob(uint32_t jobIndex, uint32_t threadIndex);
+		void CollectStats(float wallMs);
+
+	public:
+		// 0 workers -> everything runs on the main thread (still respecting the order)
+		SystemScheduler(uint32_t workerCount = DefaultWorkerCount());
+		~SystemScheduler();
+
+		SystemScheduler(const SystemScheduler&) = delete;
+		SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+		// Jolt already keeps (cores - 1) threads busy while it steps, so we only take half of the machine
+		static uint32_t DefaultWorkerCount();
+
+		void AddJob(std::string name, const Signature& readSignature, const Signature& writeSignature, bool mainThreadOnly, std::function<void()> work);
+
+		// Builds the dependency graph of the jobs added this frame, runs them and blocks until all are done.
+		// The main thread also picks up worker jobs while it waits.
+		void Run();
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+		const std::vector<ScheduledJobTiming>& GetLastFrameTimings() const { return m_LastFrameTimings; }
+		const SchedulerFrameStats& GetLastFrameStats() const { return m_LastFrameStats; }
+
+		// Dumps the last frame through the Logger, one line per job
+		void LogLastFrame() const;
+	};
+}
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <tuple>
+#include <array>
+#include <vector>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include "EngineFramework/ECS/ECSTypes.h"
+#include "EngineFramework/ECS/ComponentPool.h"
+#include "EngineFramework/ECS/Archetype.h"
+
+namespace AlphaEngine
+{
+	// <-------------------------- Views ----------------------------->
+	//
+	// Usage:
+	// for (auto [entity, transform, render] : ecs.View<TransformComponent, RenderComponent>()) { ... }
+	//
+	// Looping GetSystemEntities() and calling GetComponent<T> per entity pays for the id lookup,
+	// the pool lookup and the sparse -> dense jump EVERY single time.
+	// A View resolves the pools once when it is created, and then:
+	// Sparse Set -> walks the dense entities of the SMALLEST pool (fewest candidates to reject),
+	//               the driving pool is read by dense index, the others through their sparse array
+	// Archetype  -> walks every matching archetype chunk by chunk, which is a linear read of each column
+	// Group      -> (ecs.Group<Ts...>()) the owned pools are aligned, slot i of every pool is the same entity
+	//
+	// Change filters (only process what changed since a tick, see ECSOrchestrator::ClaimChangeTick):
+	// for (auto [entity, transform] : ecs.View<TransformComponent>().Changed<TransformComponent>(m_LastRunTick)) { ... }
+	// Several filters must ALL pass. Added<T> is a subset of Changed<T> since adding stamps both.
+	//
+	// Signature filters, mostly for tags (empty components have no pool, so they can't be one of the Ts):
+	// for (auto [entity, transform] : ecs.View<TransformComponent>().With<IsStatic>().Without<Sleeping>()) { ... }
+
+	static constexpr size_t MAX_VIEW_FILTERS = 4;
+
+	template <typename... Ts>
+	class ComponentView
+	{
+	private:
+		static_assert(sizeof...(Ts) > 0, "A View needs at least one component type");
+
+		using Pools = std::tuple<ComponentPool<Ts>*...>;
+		using Columns = std::tuple<Ts*...>;
+
+		bool m_IsArchetype = false;
+
+		// <--- Sparse set data --->
+		Pools m_Pools{};
+		// The pool we walk and its position inside m_Pools
+		const std::pmr::vector<Entity>* m_DrivingEntities = nullptr;
+		size_t m_DrivingSlot = 0;
+
+		// Owning group: only the first m_GroupSize slots are walked and nothing has to be checked
+		bool m_IsGroup = false;
+		size_t m_GroupSize = 0;
+
+		// <--- Archetype data --->
+		std::vector<const Archetype*> m_Archetypes;
+
+		// <--- Change filters --->
+		struct TickFilter
+		{
+			uint16_t componentId = 0;
+			// Passes when the tick is newer than this
+			uint32_t sinceTick = 0;
+			bool added = false;
+			// Sparse set mode reads the ticks through the pool
+			const IComponentPool* pool = nullptr;
+		};
+		std::array<TickFilter, MAX_VIEW_FILTERS> m_Filters{};
+		uint32_t m_FilterCount = 0;
+
+		// <--- Signature filters --->
+		// The orchestrator's signatures [vector index = entity index]
+		const std::vector<Signature>* m_EntitySignatures = nullptr;
+		Signature m_WithSignature;
+		Signature m_WithoutSignature;
+		bool m_HasSignatureFilter = false;
+
+		inline bool HasRowFilters() const { return m_FilterCount > 0 || m_HasSignatureFilter; }
+
+		inline bool PassesSignatureFilters(uint32_t entityIndex) const
+		{
+			if (!m_HasSignatureFilter) return true;
+			const Signature& signature = (*m_EntitySignatures)[entityIndex];
+			return (signature & m_WithSignature) == m_WithSignature && (signature & m_WithoutSignature).none();
+		}
+
+	public:
+		class Iterator
+		{
+		private:
+			const ComponentView* m_View = nullptr;
+
+			// Sparse set position (index inside the driving pool's dense array)
+			size_t m_Index = 0;
+
+			// Archetype position
+			size_t m_ArchetypeIndex = 0;
+			uint32_t m_Chunk = 0;
+			uint32_t m_Slot = 0;
+			uint32_t m_ChunkCount = 0;
+			Entity* m_Entities = nullptr;
+			Columns m_Columns{};
+			// Tick column of every filter for the current chunk
+			std::array<const uint32_t*, MAX_VIEW_FILTERS> m_FilterTicks{};
+
+			// Does every pool (apart from the one we walk) also have this entity?
+			template <size_t... I>
+			bool HasAll(uint32_t entityIndex, std::index_sequence<I...>) const
+			{
+				return ((I == m_View->m_DrivingSlot || std::get<I>(m_View->m_Pools)->Contains(entityIndex)) && ...);
+			}
+
+			template <size_t... I>
+			std::tuple<Entity, Ts&...> FetchSparse(std::index_sequence<I...>) const
+			{
+				const Entity entity = (*m_View->m_DrivingEntities)[m_Index];
+				return std::tuple<Entity, Ts&...>(entity,
+					(m_View->m_IsGroup || I == m_View->m_DrivingSlot
+						? std::get<I>(m_View->m_Pools)->GetByDenseIndex(m_Index)
+						: std::get<I>(m_View->m_Pools)->GetUnchecked(entity.GetIndex()))...);
+			}
+
+			bool PassesSparseFilters(uint32_t entityIndex) const
+			{
+				if (!m_View->PassesSignatureFilters(entityIndex)) return false;
+				for (uint32_t i = 0; i < m_View->m_FilterCount; ++i) {
+					const TickFilter& filter = m_View->m_Filters[i];
+					const uint32_t tick = filter.added ? filter.pool->GetAddedTick(entityIndex) : filter.pool->GetChangedTick(entityIndex);
+					if (tick <= filter.sinceTick) return false;
+				}
+				return true;
+			}
+
+			bool PassesChunkFilters() const
+			{
+				if (!m_View->PassesSignatureFilters(m_Entities[m_Slot].GetIndex())) return false;
+				for (uint32_t i = 0; i < m_View->m_FilterCount; ++i) {
+					if (m_FilterTicks[i][m_Slot] <= m_View->m_Filters[i].sinceTick) return false;
+				}
+				return true;
+			}
+
+			void SkipToValidSparse()
+			{
+				const size_t count = m_View->SparseCount();
+				while (m_Index < count) {
+					const uint32_t entityIndex = (*m_View->m_DrivingEntities)[m_Index].GetIndex();
+					if ((m_View->m_IsGroup || HasAll(entityIndex, std::index_sequence_for<Ts...>{})) && PassesSparseFilters(entityIndex)) return;
+					++m_Index;
+				}
+			}
+
+			void LoadChunk()
+			{
+				const Archetype* archetype = m_View->m_Archetypes[m_ArchetypeIndex];
+				m_ChunkCount = archetype->GetChunk(m_Chunk).count;
+				m_Entities = archetype->GetEntities(m_Chunk);
+				m_Columns = Columns(archetype->template GetColumn<Ts>(m_Chunk)...);
+
+				for (uint32_t i = 0; i < m_View->m_FilterCount; ++i) {
+					const TickFilter& filter = m_View->m_Filters[i];
+					m_FilterTicks[i] = filter.added ? archetype->GetAddedTicks(m_Chunk, filter.componentId) : archetype->GetChangedTicks(m_Chunk, filter.componentId);
+				}
+			}
+
+			// Moves forward until we stand on a real row (skips empty chunks/archetypes and filtered rows)
+			void SkipToValidArchetype()
+			{
+				const auto& archetypes = m_View->m_Archetypes;
+				while (m_ArchetypeIndex < archetypes.size()) {
+					if (m_Chunk < archetypes[m_ArchetypeIndex]->GetChunkCount()) {
+						LoadChunk();
+						// Rows that fail a filter are skipped without leaving the chunk
+						while (m_Slot < m_ChunkCount && !PassesChunkFilters()) ++m_Slot;
+						if (m_Slot < m_ChunkCount) return;
+
+						m_Chunk++;
+						m_Slot = 0;
+					}
+					else {
+						m_ArchetypeIndex++;
+						m_Chunk = 0;
+						m_Slot = 0;
+					}
+				}
+			}
+
+		public:
+			Iterator(const ComponentView* view, bool isEnd) : m_View(view)
+			{
+				if (m_View->m_IsArchetype) {
+					m_ArchetypeIndex = isEnd ? m_View->m_Archetypes.size() : 0;
+					if (!isEnd) SkipToValidArchetype();
+				}
+				else {
+					const size_t count = m_View->SparseCount();
+					m_Index = isEnd ? count : 0;
+					if (!isEnd && count > 0) SkipToValidSparse();
+				}
+			}
+
+			std::tuple<Entity, Ts&...> operator*() const
+			{
+				if (m_View->m_IsArchetype) {
+					return std::tuple<Entity, Ts&...>(m_Entities[m_Slot], std::get<Ts*>(m_Columns)[m_Slot]...);
+				}
+				return FetchSparse(std::index_sequence_for<Ts...>{});
+			}
+
+			Iterator& operator++()
+			{
+				if (m_View->m_IsArchetype) {
+					if (++m_Slot >= m_ChunkCount) {
+						m_Chunk++;
+						m_Slot = 0;
+						SkipToValidArchetype();
+					}
+					else if (m_View->HasRowFilters() && !PassesChunkFilters()) {
+						SkipToValidArchetype();
+					}
+				}
+				else {
+					++m_Index;
+					SkipToValidSparse();
+				}
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return m_Index == other.m_Index && m_ArchetypeIndex == other.m_ArchetypeIndex &&
+					m_Chunk == other.m_Chunk && m_Slot == other.m_Slot;
+			}
+			bool operator!=(const Iterator& other) const { return !(*this == other); }
+		};
+
+		// Sparse set view, any missing pool means no entity can match
+		ComponentView(const std::vector<Signature>& entitySignatures, ComponentPool<Ts>*... pools)
+			: m_Pools(pools...), m_EntitySignatures(&entitySignatures)
+		{
+			if (((pools == nullptr) || ...)) return;
+
+			size_t smallest = SIZE_MAX;
+			size_t slot = 0;
+			((SelectDrivingPool(pools, slot++, smallest)), ...);
+		}
+
+		// Group view, every pool is owned by 'group' so the first group size slots line up
+		ComponentView(const OwningGroup& group, const std::vector<Signature>& entitySignatures, ComponentPool<Ts>*... pools)
+			: m_Pools(pools...), m_IsGroup(true), m_GroupSize(group.GetSize()), m_EntitySignatures(&entitySignatures)
+		{
+			m_DrivingEntities = &std::get<0>(m_Pools)->GetDenseEntities();
+		}
+
+		// Archetype view, the orchestrator hands us the archetypes whose signature contains all Ts
+		ComponentView(std::vector<const Archetype*> archetypes, const std::vector<Signature>& entitySignatures)
+			: m_IsArchetype(true), m_Archetypes(std::move(archetypes)), m_EntitySignatures(&entitySignatures)
+		{
+		}
+
+		Iterator begin() const { return Iterator(this, false); }
+		Iterator end() const { return Iterator(this, true); }
+
+		// Only the entities whose T was written (or added) after 'sinceTick'
+		template <typename T>
+		ComponentView Changed(uint32_t sinceTick) const { return WithTickFilter<T>(sinceTick, false); }
+
+		// Only the entities that got their T after 'sinceTick'
+		template <typename T>
+		ComponentView Added(uint32_t sinceTick) const { return WithTickFilter<T>(sinceTick, true); }
+
+		// Only the entities that also have every T (any component, tags included)
+		template <typename ...T>
+		ComponentView With() const
+		{
+			ComponentView view = *this;
+			(view.m_WithSignature.set(Component<T>::GetId()), ...);
+			view.m_HasSignatureFilter = true;
+			return view;
+		}
+
+		// Only the entities that have none of the T
+		template <typename ...T>
+		ComponentView Without() const
+		{
+			ComponentView view = *this;
+			(view.m_WithoutSignature.set(Component<T>::GetId()), ...);
+			view.m_HasSignatureFilter = true;
+			return view;
+		}
+
+		// Upper bound of the entities this view will visit
+		size_t SizeHint() const
+		{
+			if (m_IsArchetype) {
+				size_t count = 0;
+				for (const Archetype* archetype : m_Archetypes) count += archetype->GetCount();
+				return count;
+			}
+			return SparseCount();
+		}
+
+	private:
+		size_t SparseCount() const
+		{
+			if (m_IsGroup) return m_GroupSize;
+			return m_DrivingEntities ? m_DrivingEntities->size() : 0;
+		}
+
+		template <typename T>
+		ComponentView WithTickFilter(uint32_t sinceTick, bool added) const
+		{
+			static_assert((std::is_same_v<T, Ts> || ...), "Changed<T>/Added<T> only work on a component of the View");
+			assert(m_FilterCount < MAX_VIEW_FILTERS && "Too many filters on one View!");
+
+			// Returned by value so it can be chained on the temporary from ecs.View<...>()
+			ComponentView view = *this;
+			TickFilter& filter = view.m_Filters[view.m_FilterCount++];
+			filter.componentId = static_cast<uint16_t>(Component<T>::GetId());
+			filter.sinceTick = sinceTick;
+			filter.added = added;
+			if (!m_IsArchetype) {
+				filter.pool = std::get<ComponentPool<T>*>(m_Pools);
+			}
+			return view;
+		}
+
+		template <typename T>
+		void SelectDrivingPool(ComponentPool<T>* pool, size_t slot, size_t& smallest)
+		{
+			if (pool->GetDenseEntities().size() < smallest) {
+				smallest = pool->GetDenseEntities().size();
+				m_DrivingEntities = &pool->GetDenseEntities();
+				m_DrivingSlot = slot;
+			}
+		}
+	};
+}
@@ -0,0 +1,501 @@
+#include "EngineFramework/ECS/WorldSnapshot.h"
+#include "EngineFramework/Logger.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AlphaEngine
+{
+	static constexpr uint32_t SNAPSHOT_MAGIC = 0x4E534C41; // "ALSN"
+	static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	struct SnapshotHeader
+	{
+		uint32_t magic = SNAPSHOT_MAGIC;
+		uint32_t version = SNAPSHOT_VERSION;
+		// A Signature is written as raw bytes, so both sides need the same layout
+		uint32_t signatureBytes = sizeof(Signature);
+		uint32_t maxComponents = MAX_COMPONENTS;
+		uint32_t numEntities = 0;
+		uint32_t freeIdCount = 0;
+		uint32_t blockCount = 0;
+		uint32_t changeTick = 0;
+		uint32_t primaryCamera = Entity::NullID;
+	};
+
+	struct SnapshotBlockHeader
+	{
+		uint64_t nameHash = 0;
+		// The id the component had when the snapshot was taken, used to remap the signatures
+		uint32_t capturedId = 0;
+		uint32_t componentSize = 0;
+		uint32_t count = 0;
+		uint32_t trivial = 0;
+		// Size of the T data that follows the entities and ticks
+		uint64_t dataBytes = 0;
+	};
+
+	static float MillisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Read only view of a whole file, the OS pages it in as we touch it
+	class MappedFile
+	{
+	private:
+		const std::byte* m_Data = nullptr;
+		size_t m_Size = 0;
+#ifdef _WIN32
+		HANDLE m_File = INVALID_HANDLE_VALUE;
+		HANDLE m_Mapping = nullptr;
+#else
+		int m_File = -1;
+#endif
+
+	public:
+		MappedFile(const std::string& path)
+		{
+#ifdef _WIN32
+			m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_File == INVALID_HANDLE_VALUE) return;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0) return;
+
+			m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!m_Mapping) return;
+
+			m_Data = static_cast<const std::byte*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_Data) m_Size = static_cast<size_t>(size.QuadPart);
+#else
+			m_File = open(path.c_str(), O_RDONLY);
+			if (m_File < 0) return;
+
+			struct stat info;
+			if (fstat(m_File, &info) != 0 || info.st_size == 0) return;
+
+			void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_File, 0);
+			if (mapping == MAP_FAILED) return;
+
+			// We read it front to back exactly once
+			madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+			m_Data = static_cast<const std::byte*>(mapping);
+			m_Size = static_cast<size_t>(info.st_size);
+#endif
+		}
+
+		~MappedFile()
+		{
+#ifdef _WIN32
+			if (m_Data) UnmapViewOfFile(m_Data);
+			if (m_Mapping) CloseHandle(m_Mapping);
+			if (m_File != INVALID_HANDLE_VALUE) CloseHandle(m_File);
+#else
+			if (m_Data) munmap(const_cast<std::byte*>(m_Data), m_Size);
+			if (m_File >= 0) close(m_File);
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool IsValid() const { return m_Data != nullptr; }
+		std::span<const std::byte> GetData() const { return std::span<const std::byte>(m_Data, m_Size); }
+	};
+
+	const WorldSnapshot::ComponentEntry* WorldSnapshot::FindByHash(uint64_t nameHash)
+	{
+		for (const ComponentEntry& entry : s_Components) {
+			if (entry.nameHash == nameHash) return &entry;
+		}
+		return nullptr;
+	}
+
+	const WorldSnapshot::ComponentEntry* WorldSnapshot::FindById(uint16_t componentId)
+	{
+		for (const ComponentEntry& entry : s_Components) {
+			if (entry.componentId == componentId) return &entry;
+		}
+		return nullptr;
+	}
+
+	bool WorldSnapshot::Capture(const ECSOrchestrator& ecs, std::vector<std::byte>& out)
+	{
+		out.clear();
+
+		if (ecs.m_StorageBackend != ECSStorageBackend::SparseSet) {
+			Logger::Err("WorldSnapshot: only the Sparse Set backend can be captured");
+			return false;
+		}
+
+		// Every pool with data has to be registered, otherwise its bits would be in the signatures with nothing behind them
+		std::vector<std::pair<const ComponentEntry*, const IComponentPool*>> blocks;
+		size_t estimatedBytes = sizeof(SnapshotHeader);
+		for (uint16_t componentId = 0; componentId < ecs.m_ComponentPools.size(); ++componentId) {
+			const IComponentPool* pool = ecs.m_ComponentPools[componentId].get();
+			if (!pool || pool->GetDenseEntities().empty()) continue;
+
+			const ComponentEntry* entry = FindById(componentId);
+			if (!entry) {
+				Logger::Err(std::format("WorldSnapshot: component id {} has data but was never registered, nothing captured", componentId));
+				return false;
+			}
+			blocks.emplace_back(entry, pool);
+			estimatedBytes += sizeof(SnapshotBlockHeader) + pool->GetDenseEntities().size() * (sizeof(Entity) + 2 * sizeof(uint32_t) + entry->componentSize);
+		}
+
+		// Same for the tags that are in use, they have no pool so look at the signatures
+		Signature usedSignature;
+		for (const Signature& signature : ecs.m_EntityComponentSignature) {
+			usedSignature |= signature;
+		}
+		bool missingTag = false;
+		ForEachComponent(usedSignature & IComponent::GetTagSignature(), [&](uint16_t componentId) {
+			const ComponentEntry* entry = FindById(componentId);
+			if (!entry) {
+				Logger::Err(std::format("WorldSnapshot: tag id {} is used but was never registered, nothing captured", componentId));
+				missingTag = true;
+				return;
+			}
+			// Empty block, it only carries the name so the bit can be remapped
+			blocks.emplace_back(entry, nullptr);
+			estimatedBytes += sizeof(SnapshotBlockHeader);
+			});
+		if (missingTag) return false;
+
+		SnapshotHeader header;
+		// Not m_NumEntities, that also counts ids reserved by command buffers that weren't played back yet
+		header.numEntities = static_cast<uint32_t>(ecs.m_EntityComponentSignature.size());
+		header.freeIdCount = static_cast<uint32_t>(ecs.m_FreeIDs.size());
+		header.blockCount = static_cast<uint32_t>(blocks.size());
+		header.changeTick = ecs.GetChangeTick();
+		header.primaryCamera = ecs.m_PrimaryCamera.GetId();
+
+		estimatedBytes += header.numEntities * (sizeof(Signature) + sizeof(uint16_t)) + header.freeIdCount * sizeof(uint32_t);
+		out.reserve(estimatedBytes);
+
+		SnapshotWriter writer(out);
+		writer.Write(header);
+		writer.WriteBytes(ecs.m_EntityComponentSignature.data(), header.numEntities * sizeof(Signature));
+		writer.WriteBytes(ecs.m_EntityGenerations.data(), header.numEntities * sizeof(uint16_t));
+		writer.WriteBytes(ecs.m_FreeIDs.data(), header.freeIdCount * sizeof(uint32_t));
+
+		for (const auto& [entry, pool] : blocks) {
+			const uint32_t count = pool ? static_cast<uint32_t>(pool->m_DenseToEntity.size()) : 0;
+
+			// The data size is only known once the component wrote itself, patch it afterwards
+			const size_t headerOffset = writer.GetSize();
+			SnapshotBlockHeader blockHeader;
+			blockHeader.nameHash = entry->nameHash;
+			blockHeader.capturedId = entry->componentId;
+			blockHeader.componentSize = entry->componentSize;
+			blockHeader.count = count;
+			blockHeader.trivial = entry->trivial ? 1 : 0;
+			writer.Write(blockHeader);
+			if (!pool) continue;
+
+			writer.WriteBytes(pool->m_DenseToEntity.data(), count * sizeof(Entity));
+			writer.WriteBytes(pool->m_AddedTicks.data(), count * sizeof(uint32_t));
+			writer.WriteBytes(pool->m_ChangedTicks.data(), count * sizeof(uint32_t));
+
+			const size_t dataStart = writer.GetSize();
+			entry->writeData(*pool, writer);
+			blockHeader.dataBytes = writer.GetSize() - dataStart;
+			std::memcpy(out.data() + headerOffset, &blockHeader, sizeof(blockHeader));
+		}
+
+		return true;
+	}
+
+	bool WorldSnapshot::Restore(ECSOrchestrator& ecs, std::span<const std::byte> snapshot)
+	{
+		if (ecs.m_StorageBackend != ECSStorageBackend::SparseSet) {
+			Logger::Err("WorldSnapshot: only the Sparse Set backend can be restored");
+			return false;
+		}
+
+		// <--- Validate everything first, the world is only touched once we know the snapshot is good --->
+
+		SnapshotReader reader(snapshot);
+		const SnapshotHeader header = reader.Read<SnapshotHeader>();
+		if (reader.HasFailed() || header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+			Logger::Err("WorldSnapshot: not a snapshot, or one from another version");
+			return false;
+		}
+		if (header.signatureBytes != sizeof(Signature) || header.maxComponents != MAX_COMPONENTS) {
+			Logger::Err("WorldSnapshot: the snapshot was taken with a different Signature layout");
+			return false;
+		}
+		if (header.numEntities > Entity::MaxEntities || header.freeIdCount > header.numEntities) {
+			Logger::Err("WorldSnapshot: corrupted header");
+			return false;
+		}
+
+		const std::byte* signatures = reader.Skip(header.numEntities * sizeof(Signature));
+		const std::byte* generations = reader.Skip(header.numEntities * sizeof(uint16_t));
+		const std::byte* freeIds = reader.Skip(header.freeIdCount * sizeof(uint32_t));
+
+		struct PendingBlock
+		{
+			SnapshotBlockHeader header;
+			const ComponentEntry* entry = nullptr;
+			// Where the entity array of the block starts
+			size_t offset = 0;
+		};
+		std::vector<PendingBlock> blocks;
+		blocks.reserve(header.blockCount);
+
+		// captured id -> id of the same component in this run
+		std::array<int32_t, MAX_COMPONENTS> remap;
+		remap.fill(-1);
+		bool identityRemap = true;
+
+		for (uint32_t i = 0; i < header.blockCount && !reader.HasFailed(); ++i) {
+			PendingBlock block;
+			block.header = reader.Read<SnapshotBlockHeader>();
+			block.offset = reader.GetOffset();
+			block.entry = FindByHash(block.header.nameHash);
+
+			if (!block.entry) {
+				Logger::Err("WorldSnapshot: the snapshot has a component that isn't registered");
+				return false;
+			}
+			if (block.header.componentSize != block.entry->componentSize || (block.header.trivial != 0) != block.entry->trivial ||
+				block.header.capturedId >= MAX_COMPONENTS || block.header.count > header.numEntities || (block.entry->tag && block.header.count != 0) ||
+				(block.entry->trivial && block.header.dataBytes != static_cast<uint64_t>(block.header.count) * block.header.componentSize)) {
+				Logger::Err(std::format("WorldSnapshot: component '{}' doesn't match the one in the snapshot", block.entry->name));
+				return false;
+			}
+
+			// Two blocks claiming the same captured id would leave one of them without its signature bits
+			if (remap[block.header.capturedId] != -1) {
+				Logger::Err(std::format("WorldSnapshot: component '{}' shares its captured id with another block", block.entry->name));
+				return false;
+			}
+			remap[block.header.capturedId] = block.entry->componentId;
+			identityRemap &= block.header.capturedId == block.entry->componentId;
+
+			// dataBytes comes from the file, check it against what is left before adding anything to it (the sum could wrap)
+			const size_t entityBytes = static_cast<size_t>(block.header.count) * (sizeof(Entity) + 2 * sizeof(uint32_t));
+			const size_t remaining = snapshot.size() - std::min(snapshot.size(), reader.GetOffset());
+			if (entityBytes > remaining || block.header.dataBytes > remaining - entityBytes) {
+				Logger::Err(std::format("WorldSnapshot: component '{}' has more data than the snapshot holds", block.entry->name));
+				return false;
+			}
+
+			reader.Skip(entityBytes + static_cast<size_t>(block.header.dataBytes));
+			blocks.push_back(block);
+		}
+
+		if (reader.HasFailed()) {
+			Logger::Err("WorldSnapshot: the snapshot is truncated");
+			return false;
+		}
+
+		// [entity index] who claimed it last: FREE_ID_OWNER for the free list, block index + 1 for the component blocks
+		constexpr uint32_t FREE_ID_OWNER = ~0u;
+		std::vector<uint32_t> claimedBy(header.numEntities, 0);
+
+		// Every id below indexes the per entity arrays, a single one out of range and the next CreateEntity reads past them.
+		// A free id listed twice, or one that still has components, would hand out a slot that is already live
+		for (uint32_t i = 0; i < header.freeIdCount; ++i) {
+			uint32_t freeId;
+			std::memcpy(&freeId, freeIds + i * sizeof(uint32_t), sizeof(uint32_t));
+			if (freeId >= header.numEntities) {
+				Logger::Err(std::format("WorldSnapshot: free id {} is out of range ({} entities)", freeId, header.numEntities));
+				return false;
+			}
+
+			Signature signature;
+			std::memcpy(&signature, signatures + freeId * sizeof(Signature), sizeof(Signature));
+			if (claimedBy[freeId] == FREE_ID_OWNER || signature.any()) {
+				Logger::Err(std::format("WorldSnapshot: free id {} is listed twice or still has components", freeId));
+				return false;
+			}
+			claimedBy[freeId] = FREE_ID_OWNER;
+		}
+
+		// A component has to belong to an entity that exists, and whose signature says it has it.
+		// And only once per block: a second dense slot for the same entity would be orphaned by RebuildSparseFromDense
+		for (uint32_t blockIndex = 0; blockIndex < blocks.size(); ++blockIndex) {
+			const PendingBlock& block = blocks[blockIndex];
+			const std::byte* denseEntities = snapshot.data() + block.offset;
+			for (uint32_t i = 0; i < block.header.count; ++i) {
+				Entity entity;
+				std::memcpy(&entity, denseEntities + i * sizeof(Entity), sizeof(Entity));
+
+				const uint32_t entityId = entity.GetIndex();
+				bool hasComponent = false;
+				if (entityId < header.numEntities) {
+					Signature captured;
+					std::memcpy(&captured, signatures + entityId * sizeof(Signature), sizeof(Signature));
+					hasComponent = captured.test(block.header.capturedId);
+				}
+				if (!hasComponent) {
+					Logger::Err(std::format("WorldSnapshot: component '{}' belongs to entity {}, which doesn't have it", block.entry->name, entityId));
+					return false;
+				}
+				if (claimedBy[entityId] == blockIndex + 1) {
+					Logger::Err(std::format("WorldSnapshot: entity {} has component '{}' twice", entityId, block.entry->name));
+					return false;
+				}
+				claimedBy[entityId] = blockIndex + 1;
+			}
+		}
+
+		// <--- Wipe the current world --->
+
+		// Groups first, they own pools and the pools refuse to reset while owned
+		ecs.m_Groups.clear();
+		ecs.m_RejectedGroups.clear();
+		for (auto& pool : ecs.m_ComponentPools) {
+			if (pool) pool->Reset();
+		}
+		for (System* system : ecs.m_SystemOrder) {
+			system->ClearEntities();
+		}
+		ecs.m_EntitiesToBeAdded.clear();
+		ecs.m_EntitiesToBeDestroyed.clear();
+		ecs.m_EntitiesToRefresh.clear();
+		// Their reserved ids belong to the world we are throwing away
+		for (auto& buffer : ecs.m_CommandBuffers) {
+			buffer->Clear();
+		}
+
+		// <--- Entity bookkeeping --->
+
+		ecs.m_NumEntities.store(header.numEntities);
+		ecs.m_EntityComponentSignature.resize(header.numEntities);
+		ecs.m_EntityGenerations.resize(header.numEntities);
+		ecs.m_PendingAdd.assign(header.numEntities, 0);
+		// Every system is empty now, AddEntitiesToSystems fills this back in for the live ones
+		ecs.m_SystemSignatures.assign(header.numEntities, Signature());
+		ecs.m_FreeIDs.resize(header.freeIdCount);
+
+		if (identityRemap) {
+			if (header.numEntities > 0) std::memcpy(ecs.m_EntityComponentSignature.data(), signatures, header.numEntities * sizeof(Signature));
+		}
+		else {
+			// Same components, different ids in this run, move every bit to its new place
+			for (uint32_t entityId = 0; entityId < header.numEntities; ++entityId) {
+				Signature captured;
+				std::memcpy(&captured, signatures + entityId * sizeof(Signature), sizeof(Signature));
+
+				Signature& signature = ecs.m_EntityComponentSignature[entityId];
+				signature.reset();
+				for (uint16_t componentId = 0; componentId < MAX_COMPONENTS; ++componentId) {
+					if (captured.test(componentId) && remap[componentId] != -1) {
+						signature.set(remap[componentId]);
+					}
+				}
+			}
+		}
+		// An empty vector may hand out nullptr, which memcpy doesn't take even for 0 bytes
+		if (header.numEntities > 0) std::memcpy(ecs.m_EntityGenerations.data(), generations, header.numEntities * sizeof(uint16_t));
+		if (header.freeIdCount > 0) std::memcpy(ecs.m_FreeIDs.data(), freeIds, header.freeIdCount * sizeof(uint32_t));
+
+		// Never back in time: the systems keep the ticks they claimed before the restore, a tick below them would hide
+		// every change made after it. Everything restored is stamped with it, so each system sees it all as changed once
+		const uint32_t restoreTick = std::max(ecs.GetChangeTick(), header.changeTick);
+		ecs.m_ChangeTick.store(restoreTick, std::memory_order_relaxed);
+		ecs.m_PrimaryCamera = Entity(header.primaryCamera);
+
+		// <--- Component pools --->
+
+		for (const PendingBlock& block : blocks) {
+			// Tags are done, their bits came back with the signatures
+			if (block.entry->tag) continue;
+
+			const uint32_t count = block.header.count;
+			IComponentPool* pool = block.entry->getOrCreatePool(ecs);
+
+			SnapshotReader blockReader(snapshot.subspan(block.offset));
+			pool->m_DenseToEntity.resize(count);
+			pool->m_AddedTicks.resize(count);
+			pool->m_ChangedTicks.resize(count);
+			blockReader.ReadBytes(pool->m_DenseToEntity.data(), count * sizeof(Entity));
+			blockReader.ReadBytes(pool->m_AddedTicks.data(), count * sizeof(uint32_t));
+			blockReader.ReadBytes(pool->m_ChangedTicks.data(), count * sizeof(uint32_t));
+			std::fill(pool->m_AddedTicks.begin(), pool->m_AddedTicks.end(), restoreTick);
+			std::fill(pool->m_ChangedTicks.begin(), pool->m_ChangedTicks.end(), restoreTick);
+
+			SnapshotReader dataReader(snapshot.subspan(block.offset + blockReader.GetOffset(), static_cast<size_t>(block.header.dataBytes)));
+			if (!block.entry->readData(*pool, dataReader, count)) {
+				// The sizes were validated above, so only a broken custom serializer ends up here
+				Logger::Err(std::format("WorldSnapshot: failed to read the data of '{}', its pool is left empty", block.entry->name));
+				pool->Reset();
+				continue;
+			}
+			pool->RebuildSparseFromDense();
+		}
+
+		// <--- Systems --->
+
+		// A freed slot always has an empty signature, so anything with a bit set is a live entity
+		std::vector<Entity> liveEntities;
+		liveEntities.reserve(header.numEntities - header.freeIdCount);
+		for (uint32_t entityId = 0; entityId < header.numEntities; ++entityId) {
+			if (ecs.m_EntityComponentSignature[entityId].any()) {
+				liveEntities.emplace_back(entityId, ecs.m_EntityGenerations[entityId]);
+			}
+		}
+		ecs.AddEntitiesToSystems(liveEntities);
+
+		return true;
+	}
+
+	bool WorldSnapshot::SaveToFile(const ECSOrchestrator& ecs, const std::string& path)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		std::vector<std::byte> buffer;
+		if (!Capture(ecs, buffer)) return false;
+		const float captureMs = MillisecondsSince(start);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			Logger::Err("WorldSnapshot: couldn't open " + path + " for writing");
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		if (!file) {
+			Logger::Err("WorldSnapshot: failed writing " + path);
+			return false;
+		}
+
+		Logger::Log(std::format("WorldSnapshot: saved {} entities ({} KB) to {} | capture {:.3f}ms | total {:.3f}ms",
+			ecs.m_EntityComponentSignature.size() - ecs.m_FreeIDs.size(), buffer.size() / 1024, path, captureMs, MillisecondsSince(start)));
+		return true;
+	}
+
+	bool WorldSnapshot::LoadFromFile(ECSOrchestrator& ecs, const std::string& path)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		MappedFile file(path);
+		if (!file.IsValid()) {
+			Logger::Err("WorldSnapshot: couldn't map " + path);
+			return false;
+		}
+
+		if (!Restore(ecs, file.GetData())) return false;
+
+		Logger::Log(std::format("WorldSnapshot: loaded {} entities from {} | {:.3f}ms",
+			ecs.m_NumEntities.load() - ecs.m_FreeIDs.size(), path, MillisecondsSince(start)));
+		return true;
+	}
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "EngineFramework/ECS/ECS.h"
+
+namespace AlphaEngine
+{
+	// <-------------------------- World Snapshot ----------------------------->
+	//
+	// Save/Load, level restart and rollback all need the whole ECS state as one blob of bytes.
+	// The sparse set pools are already flat arrays, so a snapshot is mostly a handful of memcpys:
+	//
+	// | Header | Signatures[N] | Generations[N] | FreeIDs | Block(Transform) | Block(Render) | ...
+	//
+	// Block | header | Entity[count] | AddedTick[count] | ChangedTick[count] | T data
+	//
+	// Component ids are handed out in the order the types are first used, so they can differ between runs.
+	// That's why every component that goes into a snapshot is registered with a NAME, the file stores
+	// the hash of that name and restoring maps it back to whatever id the type has now.
+	// The sparse arrays are not stored, they are rebuilt from the dense Entity array on restore.
+	//
+	// Trivially copyable components are blitted with memcpy, anything else needs a serializer.
+	// Tags are registered the same way, their block is just the header (the bits are in the signatures).
+	// Only the Sparse Set backend is supported, take the snapshot between frames (after UpdateEntitiesLifeTime).
+
+	constexpr uint64_t HashComponentName(std::string_view name)
+	{
+		// FNV-1a, same as the asset paths
+		uint64_t hash = 14695981039346656037ULL;
+		for (char c : name) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	// Appends raw bytes, used by the snapshot itself and by the custom component serializers
+	class SnapshotWriter
+	{
+	private:
+		std::vector<std::byte>& m_Buffer;
+
+	public:
+		SnapshotWriter(std::vector<std::byte>& buffer) : m_Buffer(buffer) {}
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			// insert instead of resize + memcpy, no point zeroing bytes we overwrite right away
+			const std::byte* bytes = static_cast<const std::byte*>(data);
+			m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+		}
+
+		template <typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Write<T> only takes trivially copyable types");
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteString(const std::string& value)
+		{
+			Write(static_cast<uint32_t>(value.size()));
+			WriteBytes(value.data(), value.size());
+		}
+
+		size_t GetSize() const { return m_Buffer.size(); }
+	};
+
+	// Reads back what a SnapshotWriter wrote. Reading past the end doesn't crash,
+	// it fails the reader and hands out zeros, so a truncated file is just a failed restore
+	class SnapshotReader
+	{
+	private:
+		std::span<const std::byte> m_Data;
+		size_t m_Offset = 0;
+		bool m_Failed = false;
+
+	public:
+		SnapshotReader(std::span<const std::byte> data) : m_Data(data) {}
+
+		bool ReadBytes(void* destination, size_t size)
+		{
+			if (m_Failed || size > m_Data.size() - m_Offset) {
+				m_Failed = true;
+				if (size > 0) std::memset(destination, 0, size);
+				return false;
+			}
+			if (size > 0) std::memcpy(destination, m_Data.data() + m_Offset, size);
+			m_Offset += size;
+			return true;
+		}
+
+		template <typename T>
+		T Read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Read<T> only takes trivially copyable types");
+			T value;
+			ReadBytes(&value, sizeof(T));
+			return value;
+		}
+
+		std::string ReadString()
+		{
+			const uint32_t size = Read<uint32_t>();
+			if (m_Failed || size > m_Data.size() - m_Offset) {
+				m_Failed = true;
+				return std::string();
+			}
+			std::string value(reinterpret_cast<const char*>(m_Data.data() + m_Offset), size);
+			m_Offset += size;
+			return value;
+		}
+
+		// Hands out the next 'size' bytes without copying them (nullptr if there aren't enough)
+		const std::byte* Skip(size_t size)
+		{
+			if (m_Failed || size > m_Data.size() - m_Offset) {
+				m_Failed = true;
+				return nullptr;
+			}
+			const std::byte* data = m_Data.data() + m_Offset;
+			m_Offset += size;
+			return data;
+		}
+
+		bool HasFailed() const { return m_Failed; }
+		size_t GetOffset() const { return m_Offset; }
+	};
+
+	class WorldSnapshot
+	{
+	public:
+		template <typename T>
+		using SerializeFn = void (*)(SnapshotWriter& writer, const T& component);
+		template <typename T>
+		using DeserializeFn = void (*)(SnapshotReader& reader, T& component);
+
+	private:
+		// Everything the snapshot needs to know about a component type, without knowing the type
+		struct ComponentEntry
+		{
+			std::string name;
+			uint64_t nameHash = 0;
+			uint16_t componentId = 0;
+			uint32_t componentSize = 0;
+			bool trivial = false;
+			// Empty component, no pool and no data, the entry only maps its signature bit
+			bool tag = false;
+
+			void (*writeData)(const IComponentPool& pool, SnapshotWriter& writer) = nullptr;
+			// Fills the (already reset) pool with 'count' components from the block data
+			bool (*readData)(IComponentPool& pool, SnapshotReader& reader, uint32_t count) = nullptr;
+			IComponentPool* (*getOrCreatePool)(ECSOrchestrator& ecs) = nullptr;
+		};
+
+		inline static std::vector<ComponentEntry> s_Components;
+
+		template <typename T>
+		static ComponentEntry& AddEntry(std::string_view name)
+		{
+			ComponentEntry entry;
+			entry.name = std::string(name);
+			entry.nameHash = HashComponentName(name);
+			entry.componentId = static_cast<uint16_t>(Component<T>::GetId());
+			entry.componentSize = sizeof(T);
+			entry.tag = IsTagComponent<T>;
+			if constexpr (!IsTagComponent<T>) {
+				entry.getOrCreatePool = [](ECSOrchestrator& ecs) -> IComponentPool* { return ecs.GetOrCreateComponentPool<T>(); };
+			}
+
+			// Registering twice (e.g. two Applications in one process) just refreshes the entry
+			for (ComponentEntry& existing : s_Components) {
+				if (existing.componentId == entry.componentId) {
+					assert(existing.nameHash == entry.nameHash && "Component registered twice with different names!");
+					existing = std::move(entry);
+					return existing;
+				}
+			}
+			assert(FindByHash(entry.nameHash) == nullptr && "Two components registered with the same name!");
+			s_Components.push_back(std::move(entry));
+			return s_Components.back();
+		}
+
+		static const ComponentEntry* FindByHash(uint64_t nameHash);
+		static const ComponentEntry* FindById(uint16_t componentId);
+
+	public:
+		// Trivially copyable components, the dense array is written and read with a single memcpy
+		template <typename T>
+		static void RegisterComponent(std::string_view name)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "This component needs a serializer, use RegisterComponent(name, serialize, deserialize)");
+			static_assert(std::is_default_constructible_v<T>, "Restoring a component needs a default constructor");
+
+			ComponentEntry& entry = AddEntry<T>(name);
+			entry.trivial = true;
+			if constexpr (!IsTagComponent<T>) {
+				entry.writeData = [](const IComponentPool& pool, SnapshotWriter& writer) {
+					const auto& data = static_cast<const ComponentPool<T>&>(pool).GetAllData();
+					writer.WriteBytes(data.data(), data.size() * sizeof(T));
+					};
+				entry.readData = [](IComponentPool& pool, SnapshotReader& reader, uint32_t count) {
+					auto& data = static_cast<ComponentPool<T>&>(pool).GetAllData();
+					data.resize(count);
+					return reader.ReadBytes(data.data(), static_cast<size_t>(count) * sizeof(T));
+					};
+			}
+		}
+
+		// Components that own memory (strings, vectors...) write themselves field by field
+		template <typename T>
+		static void RegisterComponent(std::string_view name, SerializeFn<T> serialize, DeserializeFn<T> deserialize)
+		{
+			static_assert(std::is_default_constructible_v<T>, "Restoring a component needs a default constructor");
+
+			// The entries only hold captureless function pointers, so the user functions live in statics of this instantiation
+			static SerializeFn<T> s_Serialize;
+			static DeserializeFn<T> s_Deserialize;
+			s_Serialize = serialize;
+			s_Deserialize = deserialize;
+
+			ComponentEntry& entry = AddEntry<T>(name);
+			entry.trivial = false;
+			entry.writeData = [](const IComponentPool& pool, SnapshotWriter& writer) {
+				const auto& data = static_cast<const ComponentPool<T>&>(pool).GetAllData();
+				for (const T& component : data) s_Serialize(writer, component);
+				};
+			entry.readData = [](IComponentPool& pool, SnapshotReader& reader, uint32_t count) {
+				auto& data = static_cast<ComponentPool<T>&>(pool).GetAllData();
+				data.resize(count);
+				for (T& component : data) s_Deserialize(reader, component);
+				return !reader.HasFailed();
+				};
+		}
+
+		// Serializes the whole world into 'out' (cleared first).
+		// Fails if a component type that has data was never registered, a partial world would be worse than none.
+		static bool Capture(const ECSOrchestrator& ecs, std::vector<std::byte>& out);
+
+		// Replaces the whole world with the snapshot. Everything is validated before the world is touched,
+		// so a bad or truncated snapshot leaves the current world as it was.
+		// The change tick only moves forward and every restored component counts as added/changed at it,
+		// so the systems' Changed<T>(m_LastRunTick) views pick the whole restored world up on their next run
+		static bool Restore(ECSOrchestrator& ecs, std::span<const std::byte> snapshot);
+
+		static bool SaveToFile(const ECSOrchestrator& ecs, const std::string& path);
+
+		// Memory maps the file and restores straight from the mapping (no intermediate copy of the file)
+		static bool LoadFromFile(ECSOrchestrator& ecs, const std::string& path);
+	};
+}
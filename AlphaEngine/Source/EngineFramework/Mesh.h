@@ -31,6 +31,9 @@ namespace AlphaEngine
 	class Mesh
 	{
 	public:
+		// The vertex buffer binding the per instance model matrices (locations 3 to 6) read from
+		static constexpr uint32_t INSTANCE_BUFFER_BINDING = 3;
+
 		Mesh() = default;
 
 		Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
@@ -43,7 +46,6 @@ namespace AlphaEngine
 			glDeleteVertexArrays(1, &m_VAO);
 			glDeleteBuffers(1, &m_VBO);
 			glDeleteBuffers(1, &m_EBO);
-			glDeleteBuffers(1, &m_InstanceVBO);
 		}
 
 		void KeepCpuData(bool keepData)
@@ -78,18 +80,16 @@ namespace AlphaEngine
 			glEnableVertexAttribArray(2);
 			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
 
-			glGenBuffers(1, &m_InstanceVBO);
-			glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
-			// Allocate space for up to 10,000 instances (640KB of VRAM)
-			glBufferData(GL_ARRAY_BUFFER, 10000 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-
 			// A mat4 is 4 vec4s. We enable locations 3, 4, 5, and 6
+			// They only describe the layout and read from INSTANCE_BUFFER_BINDING: the mesh has no instance buffer of its own,
+			// the renderer binds its InstanceRingBuffer there and picks the batch with baseInstance
 			for (int i = 0; i < 4; i++) {
 				glEnableVertexAttribArray(3 + i);
-				glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
-				// This makes it update per INSTANCE, not per vertex
-				glVertexAttribDivisor(3 + i, 1);
+				glVertexAttribFormat(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4) * i);
+				glVertexAttribBinding(3 + i, INSTANCE_BUFFER_BINDING);
 			}
+			// This makes it update per INSTANCE, not per vertex
+			glVertexBindingDivisor(INSTANCE_BUFFER_BINDING, 1);
 
 
 			CalculateBounds();
@@ -143,12 +143,10 @@ namespace AlphaEngine
 				glDeleteVertexArrays(1, &m_VAO);
 				glDeleteBuffers(1, &m_VBO);
 				glDeleteBuffers(1, &m_EBO);
-				glDeleteBuffers(1, &m_InstanceVBO);
 
 				m_VAO = other.m_VAO;
 				m_VBO = other.m_VBO;
 				m_EBO = other.m_EBO;
-				m_InstanceVBO = other.m_InstanceVBO;
 				m_IndexCount = other.m_IndexCount;
 
 				m_Vertices = std::move(other.m_Vertices);
@@ -158,7 +156,6 @@ namespace AlphaEngine
 				other.m_VBO = 0;
 				other.m_EBO = 0;
 				other.m_IndexCount = 0;
-				other.m_InstanceVBO = 0;
 			}
 
 			return *this;
@@ -169,7 +166,6 @@ namespace AlphaEngine
 		inline const AABB& GetLocalAABB() const { return m_LocalAABB; }
 		inline uint32_t GetMesh() const { return m_VAO; };
 		inline uint32_t GetIndexCount() const { return m_IndexCount; };
-		inline uint32_t GetInstanceVBO() const { return m_InstanceVBO; }
 		inline const std::vector<Vertex>& GetMeshAllVertices() const { return m_Vertices; };
 		inline const std::vector<uint32_t>& GetMeshAllIndices() const { return m_Indices; };
 		
@@ -179,7 +175,6 @@ namespace AlphaEngine
 		bool m_KeepMeshCPUData;
 		uint32_t m_VAO = 0, m_VBO = 0, m_EBO = 0;
 		uint32_t m_IndexCount = 0;
-		uint32_t m_InstanceVBO = 0;
 		std::vector<Vertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
 		Sphere m_LocalSphere;
@@ -27,7 +27,10 @@ namespace AlphaEngine
 
 		// Opaque objects: Sorted Front-to-Back (closest first) to take advantage of Depth Testing (the GPU skips pixels hidden behind other objects).
 		// Transparent objects : Sorted Back - to - Front so they blend correctly.
-		float depth;
+		// View space distance along the camera's forward axis (see RenderSortKey.h)
+		float depth = 0.0f;
+		// Drawn after the opaque commands of its layer, back to front
+		bool isTranslucent = false;
 
 		// skybox vars
 		bool isCubemap = false;
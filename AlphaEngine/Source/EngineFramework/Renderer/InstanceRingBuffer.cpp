@@ -0,0 +1,102 @@
+#include "EngineFramework/Renderer/InstanceRingBuffer.h"
+#include "EngineFramework/Logger.h"
+#include <string>
+
+namespace AlphaEngine
+{
+	// Persistent: stays mapped while the GPU uses it. Coherent: our writes are visible to the GPU without a flush
+	static constexpr GLbitfield RING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	InstanceRingBuffer::InstanceRingBuffer(uint32_t instancesPerRegion)
+	{
+		Create(instancesPerRegion);
+	}
+
+	InstanceRingBuffer::~InstanceRingBuffer()
+	{
+		Destroy();
+	}
+
+	void InstanceRingBuffer::Create(uint32_t instancesPerRegion)
+	{
+		m_InstancesPerRegion = instancesPerRegion;
+		m_Region = 0;
+		m_Used = 0;
+
+		const GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(glm::mat4)) * instancesPerRegion * FRAME_REGIONS;
+
+		glGenBuffers(1, &m_BufferID);
+		glBindBuffer(GL_ARRAY_BUFFER, m_BufferID);
+		// Immutable storage, the only kind that can stay mapped while we draw from it
+		glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, RING_FLAGS);
+		m_Mapped = static_cast<glm::mat4*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, RING_FLAGS));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		if (!m_Mapped) {
+			Logger::Err("[InstanceRingBuffer]: could not map " + std::to_string(size) + " bytes, instanced draws will fail");
+		}
+	}
+
+	void InstanceRingBuffer::Destroy()
+	{
+		for (GLsync& fence : m_Fences) {
+			if (fence) glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		if (m_BufferID != 0) {
+			// The GL keeps the storage alive until the draws still queued on it are done
+			glBindBuffer(GL_ARRAY_BUFFER, m_BufferID);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glDeleteBuffers(1, &m_BufferID);
+		}
+		m_BufferID = 0;
+		m_Mapped = nullptr;
+	}
+
+	void InstanceRingBuffer::WaitForRegion(uint32_t region)
+	{
+		GLsync& fence = m_Fences[region];
+		if (!fence) return;
+
+		// The flush bit makes sure the fence was actually sent to the GPU, or we would wait forever
+		while (true) {
+			const GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) break;
+			if (result == GL_WAIT_FAILED) {
+				Logger::Err("[InstanceRingBuffer]: glClientWaitSync failed");
+				break;
+			}
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	void InstanceRingBuffer::BeginFrame(uint32_t instanceCount)
+	{
+		if (instanceCount > m_InstancesPerRegion) {
+			uint32_t instancesPerRegion = m_InstancesPerRegion;
+			while (instancesPerRegion < instanceCount) instancesPerRegion *= 2;
+
+			Logger::Log("[InstanceRingBuffer]: " + std::to_string(instanceCount) + " instances this frame, growing to " +
+				std::to_string(instancesPerRegion) + " per frame");
+
+			// A brand new buffer has nothing in flight, start at its first region
+			Destroy();
+			Create(instancesPerRegion);
+			return;
+		}
+
+		m_Region = (m_Region + 1) % FRAME_REGIONS;
+		m_Used = 0;
+		WaitForRegion(m_Region);
+	}
+
+	void InstanceRingBuffer::EndFrame()
+	{
+		if (m_Fences[m_Region]) glDeleteSync(m_Fences[m_Region]);
+		m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace AlphaEngine
+{
+	// <-------------------------- Instance Ring Buffer ----------------------------->
+	//
+	// Every instanced batch used to orphan its mesh's instance VBO (glBufferData) and copy into it (glBufferSubData):
+	// a driver allocation and a copy per batch, and a hard cap of 10,000 instances.
+	// Instead there is ONE buffer, created with glBufferStorage and mapped once for its whole life
+	// (persistent + coherent), so the renderer writes the matrices straight into GPU visible memory:
+	//
+	// | frame 0 region | frame 1 region | frame 2 region |
+	//   [batch A][batch B]...
+	//   ^ baseInstance of A   ^ baseInstance of B
+	//
+	// The GPU can still be drawing the last frames while we write this one, so every frame gets its own region
+	// and a fence: before writing a region again we wait until the GPU is done with the frame that used it
+	// (with 3 regions that is the frame before last, so the wait is almost always free).
+	//
+	// The batches draw with glDrawElementsInstancedBaseInstance, the instance attributes of every mesh read the
+	// binding Mesh::INSTANCE_BUFFER_BINDING, which the renderer points at this buffer.
+	// The memory is write combined: write it in order, never read it back
+	class InstanceRingBuffer
+	{
+	public:
+		static constexpr uint32_t FRAME_REGIONS = 3;
+
+	private:
+		uint32_t m_BufferID = 0;
+		glm::mat4* m_Mapped = nullptr;
+
+		// Instances every region has room for
+		uint32_t m_InstancesPerRegion = 0;
+		// The region of the current frame, and how much of it the batches took so far
+		uint32_t m_Region = 0;
+		uint32_t m_Used = 0;
+
+		// Signaled once the GPU finished the frame that last wrote the region
+		GLsync m_Fences[FRAME_REGIONS] = {};
+
+		void Create(uint32_t instancesPerRegion);
+		void Destroy();
+		void WaitForRegion(uint32_t region);
+
+	public:
+		explicit InstanceRingBuffer(uint32_t instancesPerRegion = 16384);
+		~InstanceRingBuffer();
+
+		InstanceRingBuffer(const InstanceRingBuffer&) = delete;
+		InstanceRingBuffer& operator=(const InstanceRingBuffer&) = delete;
+
+		// Moves to the next region (waiting for the GPU if it still reads it) with room for 'instanceCount' instances.
+		// A frame that needs more than a region holds makes the buffer grow first (a new buffer, never in the middle
+		// of a frame), so check GetBufferID() after it: the VAOs have to point at the new one
+		void BeginFrame(uint32_t instanceCount);
+
+		// Index the next Push() writes to: the baseInstance of a batch that starts now
+		inline uint32_t GetNextInstance() const { return m_Region * m_InstancesPerRegion + m_Used; }
+
+		// Writes the next instance of the frame
+		inline void Push(const glm::mat4& matrix)
+		{
+			assert(m_Used < m_InstancesPerRegion && "More instances than BeginFrame made room for!");
+			m_Mapped[m_Region * m_InstancesPerRegion + m_Used++] = matrix;
+		}
+
+		// Fences the region after the frame's draws were issued
+		void EndFrame();
+
+		inline uint32_t GetBufferID() const { return m_BufferID; }
+		inline uint32_t GetInstancesPerRegion() const { return m_InstancesPerRegion; }
+	};
+}
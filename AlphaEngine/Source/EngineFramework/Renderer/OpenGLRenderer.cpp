@@ -42,11 +42,14 @@ namespace AlphaEngine
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		m_DrawQueueRCs.clear();
+		m_SortEntries.clear();
 	}
 
 	// Decouple the logic from the rendering by fueling commands
 	void OpenGLRenderer::FuelRenderCommands(const RenderCommand& command)
 	{
+		// The key is built now, while the command is still in cache, EndFrame only has to sort
+		m_SortEntries.push_back({ RenderSortKey::Make(command), static_cast<uint32_t>(m_DrawQueueRCs.size()) });
 		m_DrawQueueRCs.push_back(command);
 	}
 
@@ -75,12 +78,9 @@ namespace AlphaEngine
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
 
-		// Sort according to layers first and then by Shader and then Texture to minimize state changes.
-		std::sort(m_DrawQueueRCs.begin(), m_DrawQueueRCs.end(), [](const RenderCommand& a, const RenderCommand& b) {
-			if (a.layerID != b.layerID) return a.layerID < b.layerID;
-			if (a.shaderID != b.shaderID) return a.shaderID < b.shaderID;
-			return a.textureID < b.textureID;
-			});
+		// Sort according to layers first and then by Shader, Texture and Mesh to minimize state changes (and front to back inside a batch).
+		// Only the 16 byte key entries move (their keys were built by FuelRenderCommands), the commands are read through their index
+		RadixSortRenderEntries(m_SortEntries, m_SortScratch);
 
 		// STATE CACHING: Prevent redundant OpenGL calls
 		uint32_t activeShader = 0;
@@ -90,9 +90,16 @@ namespace AlphaEngine
 		Shader* currentShaderObj = nullptr;
 
 
-		static std::vector<glm::mat4> instanceMatrices;
-		instanceMatrices.clear();
-		instanceMatrices.reserve(1000);
+		// Every non skybox command is one instance, make room for all of them before the first batch
+		uint32_t instanceCount = 0;
+		for (const RenderCommand& cmd : m_DrawQueueRCs) {
+			if (!cmd.isCubemap) ++instanceCount;
+		}
+		m_InstanceRing.BeginFrame(instanceCount);
+
+		// The current batch: where its matrices start in the ring (its baseInstance) and how many it has
+		uint32_t batchStart = 0;
+		uint32_t batchCount = 0;
 
 
 		glm::mat4 viewInv = glm::inverse(m_ActiveView);
@@ -100,9 +107,9 @@ namespace AlphaEngine
 
 		// EXECUTION LOOP
 		// ALSO AVOIDING THE Strings all the time is important !
-		for (size_t i = 0; i < m_DrawQueueRCs.size(); ++i) {
+		for (size_t i = 0; i < m_SortEntries.size(); ++i) {
 
-			const auto& cmd = m_DrawQueueRCs[i];
+			const auto& cmd = m_DrawQueueRCs[m_SortEntries[i].index];
 
 			// --- SHADER BINDING ---
 			if (cmd.shaderID != activeShader) {
@@ -168,6 +175,11 @@ namespace AlphaEngine
 			if (cmd.vao != activeVAO) {
 				glBindVertexArray(cmd.vao);
 				activeVAO = cmd.vao;
+
+				// The instance attributes are part of the VAO, point them at the ring
+				if (!cmd.isCubemap) {
+					glBindVertexBuffer(Mesh::INSTANCE_BUFFER_BINDING, m_InstanceRing.GetBufferID(), 0, sizeof(glm::mat4));
+				}
 			}
 
 
@@ -197,46 +209,41 @@ namespace AlphaEngine
 
 				// <------------ Batch Processing ------------>
 				// One of the most common bottlenecks in game engines are Draw Call Overhead.
-				// By using instanceMatrices we do pre-calculations that are needed and memory management
+				// By writing the matrices straight into the instance ring we do pre-calculations that are needed and memory management
 				// And here we do The collection The batching
 				// The code looks at the next item in the list. If the next item uses a different mesh, shader, or texture, 
 				// it means the "Group" is finished.
 				// We can only instance objects that share the exact same GPU state
 
 
-				instanceMatrices.push_back(cmd.transform);
+				if (batchCount == 0) batchStart = m_InstanceRing.GetNextInstance();
+				m_InstanceRing.Push(cmd.transform);
+				++batchCount;
 
-				bool isLast = (i == m_DrawQueueRCs.size() - 1);
+				bool isLast = (i == m_SortEntries.size() - 1);
+				const RenderCommand* next = isLast ? nullptr : &m_DrawQueueRCs[m_SortEntries[i + 1].index];
 				bool nextIsDifferent = !isLast && (
-					m_DrawQueueRCs[i + 1].vao != cmd.vao ||
-					m_DrawQueueRCs[i + 1].shaderID != cmd.shaderID ||
-					m_DrawQueueRCs[i + 1].textureID != cmd.textureID ||
-					m_DrawQueueRCs[i + 1].isCubemap 
+					next->vao != cmd.vao ||
+					next->shaderID != cmd.shaderID ||
+					next->textureID != cmd.textureID ||
+					next->isCubemap 
 					);
 
 				if (isLast || nextIsDifferent) {
 
-					//  Get the Instance VBO for this mesh
-					uint32_t instanceVBO = ServiceLocator::Get<AssetManager>().GetMeshInstanceVBO(cmd.vao);
-
-					// HERE We do the "orphaning"
-					// The "Orphan" tells the GPU Driver 
-					// "I am about to overwrite this. Don't wait for the previous frame to finishjust give me a fresh block of memory."
-
-					glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-					glBufferData(GL_ARRAY_BUFFER, 10000 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-
-					// Now upload the actual data
-					glBufferSubData(GL_ARRAY_BUFFER, 0, instanceMatrices.size() * sizeof(glm::mat4), instanceMatrices.data());
-
+					// No orphaning and no upload here: the matrices are already in GPU visible memory.
+					// baseInstance tells the GPU where the batch starts, so instance 0 reads the ring at batchStart
 					//  ONE DRAW CALL for the whole group
-					glDrawElementsInstanced(GL_TRIANGLES, cmd.indexCount, GL_UNSIGNED_INT, nullptr, (GLsizei)instanceMatrices.size());
+					glDrawElementsInstancedBaseInstance(GL_TRIANGLES, cmd.indexCount, GL_UNSIGNED_INT, nullptr, (GLsizei)batchCount, batchStart);
 
-					instanceMatrices.clear(); // Reset for next batch
+					batchCount = 0; // Reset for next batch
 				}
 			}
 		}
 
+		// The GPU reads this frame's region until this fence is signaled
+		m_InstanceRing.EndFrame();
+
 		// Cleaning Up
 		glBindVertexArray(0);
 		glUseProgram(0);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "EngineFramework/Renderer/IRenderer.h"
+#include "EngineFramework/Renderer/InstanceRingBuffer.h"
+#include "EngineFramework/Renderer/RenderSortKey.h"
 #include "EngineFramework/Logger.h"
 #include <vector>
 #include <glad/gl.h>
@@ -17,6 +19,11 @@ namespace AlphaEngine
 		glm::mat4 m_ActiveView;
 		uint32_t m_CameraUBO;
 		std::vector<RenderCommand> m_DrawQueueRCs;
+		// What actually gets sorted: a key + index per command, m_DrawQueueRCs stays in submission order
+		std::vector<RenderSortEntry> m_SortEntries;
+		std::vector<RenderSortEntry> m_SortScratch;
+		// Where every instanced batch writes its model matrices
+		InstanceRingBuffer m_InstanceRing;
 		
 	public:
 		OpenGLRenderer();
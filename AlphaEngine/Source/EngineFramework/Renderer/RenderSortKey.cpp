@@ -0,0 +1,64 @@
+#include "EngineFramework/Renderer/RenderSortKey.h"
+#include <algorithm>
+#include <utility>
+
+namespace AlphaEngine
+{
+	static constexpr uint32_t RADIX_BITS = 11;
+	static constexpr uint32_t RADIX_BUCKETS = 1u << RADIX_BITS;
+	static constexpr uint64_t RADIX_MASK = RADIX_BUCKETS - 1;
+	static constexpr uint32_t RADIX_PASSES = (64 + RADIX_BITS - 1) / RADIX_BITS;
+
+	void RadixSortRenderEntries(std::vector<RenderSortEntry>& entries, std::vector<RenderSortEntry>& scratch)
+	{
+		const size_t count = entries.size();
+
+		// The histograms cost the same whatever the count (48 KB to clear, 6 x 2048 prefix sums),
+		// below ~1000 entries a comparison sort is done before that
+		if (count <= 1024) {
+			std::stable_sort(entries.begin(), entries.end(), [](const RenderSortEntry& a, const RenderSortEntry& b) { return a.key < b.key; });
+			return;
+		}
+
+		// One read of the keys counts the digits of every pass
+		uint32_t histograms[RADIX_PASSES][RADIX_BUCKETS] = {};
+		for (const RenderSortEntry& entry : entries) {
+			const uint64_t key = entry.key;
+			for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+				histograms[pass][(key >> (pass * RADIX_BITS)) & RADIX_MASK]++;
+			}
+		}
+
+		scratch.resize(count);
+		RenderSortEntry* source = entries.data();
+		RenderSortEntry* destination = scratch.data();
+
+		for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+			uint32_t* histogram = histograms[pass];
+			const uint32_t shift = pass * RADIX_BITS;
+
+			// Every key has the same digit here, the pass would copy everything without reordering anything
+			if (histogram[(source[0].key >> shift) & RADIX_MASK] == count) continue;
+
+			// Counts -> where every digit starts in the destination
+			uint32_t offset = 0;
+			for (uint32_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+				const uint32_t digitCount = histogram[digit];
+				histogram[digit] = offset;
+				offset += digitCount;
+			}
+
+			// In order of the source, so entries with the same digit keep the order of the previous passes
+			for (size_t i = 0; i < count; ++i) {
+				const RenderSortEntry entry = source[i];
+				destination[histogram[(entry.key >> shift) & RADIX_MASK]++] = entry;
+			}
+			std::swap(source, destination);
+		}
+
+		// An odd number of passes leaves the result in the scratch buffer
+		if (source != entries.data()) {
+			entries.swap(scratch);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "EngineFramework/Renderer/IRenderer.h"
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace AlphaEngine
+{
+	// <-------------------------- Render Sort Keys ----------------------------->
+	//
+	// A RenderCommand is over 150 bytes (two mat4s), sorting them moves all of that around on every swap.
+	// Instead the renderer sorts one 16 byte entry per command: everything the order depends on packed in a 64 bit key,
+	// plus the index of the command. The commands themselves never move.
+	//
+	// Opaque      | layer 4 | 0 | shader 12 | texture 12 | mesh 11 | depth 24          | -> state changes first, then front to back
+	// Translucent | layer 4 | 1 | far to near depth 24 | shader 12 | texture 12 | mesh 11 | -> back to front, so they blend correctly
+	//
+	// Shader and texture ids are path hashes and the mesh is a VAO name, the key keeps their low bits.
+	// Two ids sharing those bits may end up interleaved, which costs a state change, never a wrong draw:
+	// the renderer still compares the real ids before batching
+	struct RenderSortEntry
+	{
+		uint64_t key;
+		// Into the renderer's command array
+		uint32_t index;
+	};
+
+	namespace RenderSortKey
+	{
+		constexpr uint32_t LAYER_BITS = 4;
+		constexpr uint32_t SHADER_BITS = 12;
+		constexpr uint32_t TEXTURE_BITS = 12;
+		constexpr uint32_t MESH_BITS = 11;
+		constexpr uint32_t DEPTH_BITS = 24;
+
+		constexpr uint32_t MAX_DEPTH = (1u << DEPTH_BITS) - 1;
+
+		// A positive float orders the same as its bits. Without the sign bit, the top 24 of them
+		// (exponent + 16 bits of mantissa) keep that order without knowing the far plane.
+		// Behind the camera (and NaN) is 0
+		inline uint32_t QuantizeDepth(float depth)
+		{
+			if (!(depth > 0.0f)) return 0;
+			return std::bit_cast<uint32_t>(depth) >> (31 - DEPTH_BITS);
+		}
+
+		inline uint64_t Make(const RenderCommand& command)
+		{
+			const uint64_t layer = command.layerID < (1u << LAYER_BITS) ? command.layerID : (1u << LAYER_BITS) - 1;
+			const uint64_t shader = command.shaderID & ((1u << SHADER_BITS) - 1);
+			const uint64_t texture = command.textureID & ((1u << TEXTURE_BITS) - 1);
+			const uint64_t mesh = command.vao & ((1u << MESH_BITS) - 1);
+			const uint64_t depth = QuantizeDepth(command.depth);
+
+			uint64_t key = layer << 60;
+			if (!command.isTranslucent) {
+				key |= shader << 47 | texture << 35 | mesh << 24 | depth;
+			}
+			else {
+				key |= 1ull << 59 | static_cast<uint64_t>(MAX_DEPTH - depth) << 35 | shader << 23 | texture << 11 | mesh;
+			}
+			return key;
+		}
+	}
+
+	// Stable LSD radix sort by key, 11 bits per pass (6 passes instead of the 8 of a byte per pass, the 2048 counters
+	// of a pass still fit in L1). 'scratch' is the second buffer the passes ping pong with,
+	// keep it around between frames so neither vector reallocates.
+	// A pass whose digit is the same in every key is skipped
+	void RadixSortRenderEntries(std::vector<RenderSortEntry>& entries, std::vector<RenderSortEntry>& scratch);
+}
@@ -2,7 +2,7 @@
 
 #include "EngineFramework/ECS/ECS.h"
 #include "EngineFramework/Components/CameraComponent.h"
-#include "EngineFramework/Components/TransformComponent.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
 #include "EngineFramework/Renderer/IRenderer.h"
 #include "EngineFramework/Logger.h"
 #include <glm/glm.hpp>
@@ -30,8 +30,9 @@ namespace AlphaEngine
 				});
 
 
-			RequireComponent<TransformComponent>();
-			RequireComponent<CameraComponent>();
+			// The world position, so a camera attached to something follows it
+			RequireComponent<WorldTransformComponent>(ComponentAccess::Read);
+			RequireComponent<CameraComponent>(ComponentAccess::ReadWrite);
 		}
 
 		
@@ -40,15 +41,12 @@ namespace AlphaEngine
 		{
 			float currentAspect = m_CurrentAspectRatio;
 
-			for (auto const& entity : GetSystemEntities())
+			for (auto [entity, worldTransform, cameraComp] : ecsOrchestrator.View<WorldTransformComponent, CameraComponent>())
 			{
-				auto& transformComp = ecsOrchestrator.GetComponent<TransformComponent>(entity);
-				auto& cameraComp = ecsOrchestrator.GetComponent<CameraComponent>(entity);
-
 				cameraComp.aspect = currentAspect;
 
 				cameraComp.viewMatrix = glm::lookAt(
-					transformComp.position, 
+					worldTransform.GetPosition(),
 					cameraComp.target,      
 					cameraComp.up           
 				);
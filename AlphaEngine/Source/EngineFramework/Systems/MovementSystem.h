@@ -14,20 +14,14 @@ namespace AlphaEngine
 	public:
 		MovementSystem()
 		{
-			RequireComponent<TransformComponent>();
-			RequireComponent<VelocityComponent>();
+			RequireComponent<TransformComponent>(ComponentAccess::ReadWrite);
+			RequireComponent<VelocityComponent>(ComponentAccess::ReadWrite);
 		}
 
 		void RunSystem(ECSOrchestrator& ecs, float deltaTime)
 		{
-			for (auto const& entity : GetSystemEntities()) {
+			for (auto [entity, transform, vel] : ecs.View<TransformComponent, VelocityComponent>()) {
 
-				if (!ecs.HasComponent<TransformComponent>(entity)) continue;
-
-				auto& transform = ecs.GetComponent<TransformComponent>(entity);
-				auto& vel = ecs.GetComponent<VelocityComponent>(entity);
-
-				
 				if (!vel.isGrounded) {
 					vel.linearVelocity.y += vel.gravity * deltaTime;
 				}
@@ -42,6 +36,9 @@ namespace AlphaEngine
 				else {
 					vel.isGrounded = false;
 				}
+
+				// So the TransformSystem picks the new position up
+				ecs.MarkChanged<TransformComponent>(entity);
 			}
 		}
 	};
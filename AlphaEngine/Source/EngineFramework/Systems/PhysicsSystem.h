@@ -22,9 +22,12 @@
 #include "EngineFrameWork/Components/RigidBodyComponent.h"
 #include "EngineFrameWork/Components/RendererComponent.h"
 #include "EngineFrameWork/Components/TransformComponent.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
+#include "EngineFramework/Components/HierarchyComponent.h"
 #include "EngineFramework/MainContactListener.h"
 #include <glm/gtc/quaternion.hpp>
 #include <iostream>
+#include <span>
 
 namespace AlphaEngine
 {
@@ -59,8 +62,14 @@ namespace AlphaEngine
 
 		PhysicsSystem() 
 		{
-			RequireComponent<RigidBodyComponent>();
-			RequireComponent<TransformComponent>();
+			RequireComponent<RigidBodyComponent>(ComponentAccess::ReadWrite);
+			RequireComponent<TransformComponent>(ComponentAccess::ReadWrite);
+			// A body attached to a parent writes its Transform relative to the parent's cached world matrix
+			DeclareAccess<HierarchyComponent>(ComponentAccess::Read);
+			DeclareAccess<WorldTransformComponent>(ComponentAccess::Read);
+
+			// Steps Jolt, creates bodies and publishes the collision events
+			SetRunsOnMainThread(true);
 
 			// Jolt requires a temp allocator for per-frame memory (mostly for optimization)
 			jolt_TempAllocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);
@@ -166,11 +175,10 @@ namespace AlphaEngine
 			return bodyInterface.CreateAndAddBody(settings, JPH::EActivation::DontActivate);
 		}
 
-		// Creating a sphere Body
-		JPH::BodyID CreateSphereBody(Entity entity, glm::vec3 pos, float radius, bool isStatic)
+		// The settings of a sphere body, without a position or an entity yet.
+		// Copies share the shape, so CreateBodies with them builds the sphere shape once for the whole batch
+		JPH::BodyCreationSettings MakeSphereSettings(float radius, bool isStatic)
 		{
-			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
-
 			JPH::SphereShapeSettings settings(radius);
 			JPH::ShapeRefC shape = settings.Create().Get();
 
@@ -178,20 +186,70 @@ namespace AlphaEngine
 			JPH::EMotionType currentMotionType = isStatic ? JPH::EMotionType::Static : JPH::EMotionType::Dynamic;
 			JPH::ObjectLayer currentLayer = isStatic ? PhysObjectLayers::NON_MOVING : PhysObjectLayers::MOVING;
 
-			JPH::BodyCreationSettings bodySettings(shape, JPH::RVec3(pos.x, pos.y, pos.z), JPH::Quat::sIdentity(), currentMotionType, currentLayer);
+			JPH::BodyCreationSettings bodySettings(shape, JPH::RVec3::sZero(), JPH::Quat::sIdentity(), currentMotionType, currentLayer);
 			bodySettings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
 			bodySettings.mFriction = 0.5f;
 			bodySettings.mLinearDamping = 0.2f; 
 			bodySettings.mAngularDamping = 0.2f;
 			
 			bodySettings.mMassPropertiesOverride.mMass = 1.0f;
-			bodySettings.mUserData = static_cast<uint64_t>(entity.GetId());
 
 			if (!isStatic) bodySettings.mRestitution = 0.7f;
 
+			return bodySettings;
+		}
+
+		// Creating a sphere Body
+		JPH::BodyID CreateSphereBody(Entity entity, glm::vec3 pos, float radius, bool isStatic)
+		{
+			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
+
+			JPH::BodyCreationSettings bodySettings = MakeSphereSettings(radius, isStatic);
+			bodySettings.mPosition = JPH::RVec3(pos.x, pos.y, pos.z);
+			bodySettings.mUserData = static_cast<uint64_t>(entity.GetId());
+
 			return bodyInterface.CreateAndAddBody(bodySettings, JPH::EActivation::Activate);
 		}
 
+		// One body per entity from the same settings (prefab instances), all added to the world in ONE batch:
+		// AddBodiesPrepare/Finalize builds a broad phase tree for the batch and merges it once,
+		// instead of inserting (and locking) body by body like CreateAndAddBody.
+		// Every entity needs a RigidBodyComponent (gets the body id) and a TransformComponent (where the body starts,
+		// read as world space, so root entities only)
+		void CreateBodies(ECSOrchestrator& ecs, std::span<const Entity> entities, JPH::BodyCreationSettings settings)
+		{
+			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
+
+			std::vector<JPH::BodyID> bodyIDs;
+			bodyIDs.reserve(entities.size());
+
+			for (const Entity& entity : entities) {
+				assert(ecs.HasComponent<RigidBodyComponent>(entity) && ecs.HasComponent<TransformComponent>(entity));
+
+				const auto& transform = ecs.GetComponent<TransformComponent>(entity);
+				settings.mPosition = JPH::RVec3(transform.position.x, transform.position.y, transform.position.z);
+				settings.mRotation = JPH::Quat(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w);
+				settings.mUserData = static_cast<uint64_t>(entity.GetId());
+
+				// Created, but not in the world yet
+				JPH::Body* body = bodyInterface.CreateBody(settings);
+				if (!body) {
+					Logger::Err("[PhysicsSystem]: Out of bodies, " + std::to_string(entities.size() - bodyIDs.size()) + " entities got none");
+					break;
+				}
+
+				bodyIDs.push_back(body->GetID());
+				ecs.GetComponent<RigidBodyComponent>(entity).bodyID = body->GetID();
+			}
+
+			if (bodyIDs.empty()) return;
+
+			const JPH::EActivation activation = settings.mMotionType == JPH::EMotionType::Static ? JPH::EActivation::DontActivate : JPH::EActivation::Activate;
+			const int bodyCount = static_cast<int>(bodyIDs.size());
+			JPH::BodyInterface::AddState addState = bodyInterface.AddBodiesPrepare(bodyIDs.data(), bodyCount);
+			bodyInterface.AddBodiesFinalize(bodyIDs.data(), bodyCount, addState, activation);
+		}
+
 		JPH::BodyID CreateBoxBody(Entity entity, glm::vec3 pos, glm::vec3 halfExtents, bool isStatic, float restitution = 0.0f)
 		{
 			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
@@ -267,6 +325,23 @@ namespace AlphaEngine
 			return collector.HadHit() ? collector.mHit.mBodyID : JPH::BodyID();
 		}
 
+		// Compact() renumbered the entities: every body carries its entity's handle in mUserData
+		void OnEntitiesRemapped(ECSOrchestrator& ecs, const EntityRemap& remap) override
+		{
+			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
+			for (auto [entity, rb] : ecs.View<RigidBodyComponent>()) {
+				if (!rb.bodyID.IsInvalid()) {
+					bodyInterface.SetUserData(rb.bodyID, static_cast<uint64_t>(entity.GetId()));
+				}
+			}
+
+			for (PendingMeshRequest& request : m_PendingMeshRequests) {
+				request.entity = remap(request.entity);
+			}
+			// A request whose entity died before its mesh loaded has nobody to give the body to
+			std::erase_if(m_PendingMeshRequests, [](const PendingMeshRequest& request) { return !request.entity.IsValid(); });
+		}
+
 		void RunSystem(ECSOrchestrator& ecs, float deltaTime) {
 
 			//  Cap deltaTime so we wont have to catch up perfectly and create more lagging
@@ -323,8 +398,11 @@ namespace AlphaEngine
 
 				for (auto& contact : jolt_MainContactListener->m_EventQueue) {
 					// Safe lookup on Main Thread
-					Entity e1 = static_cast<Entity>(bi.GetUserData(contact.id1));
-					Entity e2 = static_cast<Entity>(bi.GetUserData(contact.id2));
+					// mUserData holds the full handle, so a body that outlived its entity
+					// comes back with an old generation and we can drop the event
+					Entity e1(static_cast<uint32_t>(bi.GetUserData(contact.id1)));
+					Entity e2(static_cast<uint32_t>(bi.GetUserData(contact.id2)));
+					if (!ecs.IsAlive(e1) || !ecs.IsAlive(e2)) continue;
 
 					// If it's a 'Removed' event, we might need to check if the body still exists
 					bool isSensor = contact.isSensor;
@@ -342,19 +420,37 @@ namespace AlphaEngine
 			// Sync Jolt results back to ECS Transforms
 			JPH::BodyInterface& bodyInterface = jolt_PhysicsSystem->GetBodyInterface();
 
-			for (auto const& entity : GetSystemEntities()) {
-				auto& rb = ecs.GetComponent<RigidBodyComponent>(entity);
-				auto& transform = ecs.GetComponent<TransformComponent>(entity);
+			// The View drives from the (smaller) RigidBody pool and looks up the Transform.
+			for (auto [entity, rb, transform] : ecs.View<RigidBodyComponent, TransformComponent>()) {
 
+				// Sleeping and static bodies don't move, so leave their Transform (and its change tick) alone.
+				// We still sync once on the frame a body falls asleep, it could have moved during that last step
+				const bool isActive = bodyInterface.IsActive(rb.bodyID);
+				if (!isActive && !rb.wasActive) continue;
+				rb.wasActive = isActive;
 
 				// Fetch the simulated position/rotation from Jolt
 				JPH::RVec3 pos;
 				JPH::Quat rot;
 				bodyInterface.GetPositionAndRotation(rb.bodyID, pos, rot);
 
-				// Copy to Transform so the RenderSystem can see it
-				transform.position = glm::vec3(pos.GetX(), pos.GetY(), pos.GetZ());
-				transform.rotation = glm::quat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ());
+				// Copy to Transform so the TransformSystem (and then the RenderSystem) can see it
+				const glm::vec3 worldPosition(pos.GetX(), pos.GetY(), pos.GetZ());
+				const glm::quat worldRotation(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ());
+
+				// Jolt simulates in world space, but a child's Transform is relative to its parent.
+				// A parent without a Transform (a grouping node) counts as the origin, like in the TransformSystem
+				const Entity parent = ecs.HasComponent<HierarchyComponent>(entity) ? ecs.GetComponent<HierarchyComponent>(entity).parent : Entity();
+				if (parent.IsValid() && ecs.HasComponent<WorldTransformComponent>(parent)) {
+					const auto& parentWorld = ecs.GetComponent<WorldTransformComponent>(parent);
+					transform.position = glm::vec3(glm::inverse(parentWorld.matrix) * glm::vec4(worldPosition, 1.0f));
+					transform.rotation = glm::inverse(parentWorld.GetRotation()) * worldRotation;
+				}
+				else {
+					transform.position = worldPosition;
+					transform.rotation = worldRotation;
+				}
+				ecs.MarkChanged<TransformComponent>(entity);
 				JPH::Vec3 vel = bodyInterface.GetLinearVelocity(rb.bodyID);
 				JPH::Vec3 angVel = bodyInterface.GetAngularVelocity(rb.bodyID);
 			}
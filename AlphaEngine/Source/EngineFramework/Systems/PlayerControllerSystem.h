@@ -13,8 +13,8 @@ namespace AlphaEngine
 	public:
 		PlayerControllerSystem()
 		{
-			RequireComponent<PlayerControllerComponent>();
-			RequireComponent<VelocityComponent>();
+			RequireComponent<PlayerControllerComponent>(ComponentAccess::Read);
+			RequireComponent<VelocityComponent>(ComponentAccess::ReadWrite);
 		}
 
 		void RunSystem(ECSOrchestrator& ecs, Input& input)
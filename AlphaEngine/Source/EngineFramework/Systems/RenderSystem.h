@@ -2,7 +2,8 @@
 
 #include "EngineFramework/ECS/ECS.h"
 #include "EngineFramework/Components/RendererComponent.h"
-#include "EngineFramework/Components/TransformComponent.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
+#include "EngineFramework/Components/CameraComponent.h"
 #include "EngineFramework/Renderer/IRenderer.h"
 #include "EngineFramework/Logger.h"
 #include "EngineFramework/AssetManager.h"
@@ -19,11 +20,18 @@ namespace AlphaEngine
 	public:
 		RenderSystem() 
 		{
-			RequireComponent<TransformComponent>();
-			RequireComponent<RenderComponent>();
+			// The world matrices are cached by the TransformSystem
+			RequireComponent<WorldTransformComponent>(ComponentAccess::Read);
+			RequireComponent<RenderComponent>(ComponentAccess::Read);
+
+			// viewProj of the primary camera
+			DeclareAccess<CameraComponent>(ComponentAccess::Read);
+
+			// Issues the OpenGL calls
+			SetRunsOnMainThread(true);
 		}
 
-		void RunSystem(IRenderer& renderer, ECSOrchestrator& ecsOrchestrator) const
+		void RunSystem(IRenderer& renderer, ECSOrchestrator& ecsOrchestrator)
 		{
 
 			auto mainCam = ecsOrchestrator.GetPrimaryCamera();
@@ -43,31 +51,29 @@ namespace AlphaEngine
 				Logger::Err("Not Valid Camera found!");
 				return;
 			}
-			
-			for (auto const& entity : GetSystemEntities())
-			{
-				if (!ecsOrchestrator.HasComponent<TransformComponent>(entity)) continue;
-
-				auto& transformComp = ecsOrchestrator.GetComponent<TransformComponent>(entity);
-				auto& renderComp = ecsOrchestrator.GetComponent<RenderComponent>(entity);
-
 
+			// WorldTransform and Render are owned by a group, so slot i of both pools is the same entity
+			// and this is a linear walk of two arrays
+			for (auto [entity, worldTransform, renderComp] : ecsOrchestrator.Group<WorldTransformComponent, RenderComponent>())
+			{
+				float viewDepth = 0.0f;
 				if (!renderComp.isSkybox)
 				{
 					// 1. Get the local radius from the Mesh (cached in AssetManager)
 					float localRadius = assetManager.GetMeshRadius(renderComp.meshHandler);
 
-					// 2. Scale the radius based on the entity's transform
-					float maxScale = glm::max(transformComp.scale.x, glm::max(transformComp.scale.y, transformComp.scale.z));
-
+					// 2. Scale the radius based on the entity's world matrix (parents' scale included)
 					Sphere worldSphere;
-					worldSphere.center = transformComp.position; // World position
-					worldSphere.radius = localRadius * maxScale;
+					worldSphere.center = worldTransform.GetPosition();
+					worldSphere.radius = localRadius * worldTransform.GetMaxScale();
 
 					// 3. Test: If the sphere is outside, don't even build the RenderCommand
 					if (!Intersection::Intersects(cameraFrustum, worldSphere)) {
 						continue;
 					}
+
+					// The camera looks down -Z in view space
+					viewDepth = -(cameraComp.viewMatrix * glm::vec4(worldSphere.center, 1.0f)).z;
 				}
 				renderedCount++;
 
@@ -77,9 +83,10 @@ namespace AlphaEngine
 				rCmd.textureID = renderComp.textureHandler.id;
 				rCmd.vao = assetManager.GetMeshVAO(renderComp.meshHandler);
 				rCmd.indexCount = assetManager.GetMeshIndexCount(renderComp.meshHandler);
-				rCmd.transform = transformComp.GetTransform(); // The 4x4 matrix
+				rCmd.transform = worldTransform.matrix; // The 4x4 matrix (cached)
 				rCmd.isCubemap = renderComp.isSkybox;
 				rCmd.layerID = renderComp.layerID;
+				rCmd.depth = viewDepth;
 				
 				// Optimization check: Checking X and Y axis
 				// TODO: Although this will be changed to fit our needs Or What we consider to be invisible!
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "EngineFramework/ECS/ECS.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
+#include "EngineFramework/Geometry.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace AlphaEngine
+{
+	// "Who is near this point" without asking physics (PhysicsSystem::CastRay) or walking every transform.
+	//
+	// A hashed uniform grid over the world position of every entity with a WorldTransformComponent.
+	// Space is cut in cubes of m_CellSize, only the cubes that have someone in them exist:
+	//
+	// Lookup (cell coordinates -> cell) | (0,0,0) -> 0 | (3,0,-1) -> 1 | (-7,2,5) -> 2 ...
+	// Cells                             | [e4 e9 e1] | [e2] | [e7 e5] ...
+	//
+	// so the world has no bounds and costs nothing where it's empty. Every cell keeps the positions next to the
+	// entities, a query only touches the cells its shape overlaps and never goes back to the ECS: O(k) instead of O(N).
+	//
+	// Only the entities whose WorldTransformComponent changed since the last run are moved, and one that stays
+	// in its cell only has its position overwritten. Run it after the TransformSystem, and query after it ran:
+	//
+	// Entity nearby[64];
+	// const size_t found = grid.QuerySphere({ position, 10.0f }, nearby);  // can be more than 64, only 64 are written
+	//
+	// Entities are points here: a big object is found when its origin is inside the shape, not its bounds
+	class SpatialGridSystem : public System
+	{
+	private:
+		static constexpr uint32_t INVALID_CELL = 0xFFFFFFFF;
+
+		// Cell coordinates are kept in 21 bits each so the three of them pack into one 64 bit key
+		static constexpr int32_t COORDINATE_BITS = 21;
+		static constexpr int32_t MIN_COORDINATE = -(1 << (COORDINATE_BITS - 1));
+		static constexpr int32_t MAX_COORDINATE = (1 << (COORDINATE_BITS - 1)) - 1;
+
+		struct GridEntry
+		{
+			Entity entity;
+			glm::vec3 position;
+		};
+
+		struct GridCell
+		{
+			uint64_t key = 0;
+			glm::ivec3 coordinates = glm::ivec3(0);
+			std::vector<GridEntry> entries;
+		};
+
+		// Where an entity sits in the grid [vector index = entity index]
+		struct EntityLocation
+		{
+			uint32_t cell = INVALID_CELL;
+			uint32_t slot = 0;
+		};
+
+		float m_CellSize;
+		float m_InverseCellSize;
+
+		std::unordered_map<uint64_t, uint32_t> m_CellLookup;
+		std::vector<GridCell> m_Cells;
+		// Cells that became empty, reused (with their capacity) before making new ones
+		std::vector<uint32_t> m_FreeCells;
+		std::vector<EntityLocation> m_Locations;
+		size_t m_EntryCount = 0;
+
+		// Joined the system since the last run, inserted by RunSystem (their world matrix may not be final yet)
+		std::vector<Entity> m_Added;
+
+		inline glm::ivec3 GetCellCoordinates(const glm::vec3& position) const
+		{
+			const glm::vec3 scaled = glm::floor(position * m_InverseCellSize);
+			return glm::ivec3(
+				static_cast<int32_t>(std::clamp(scaled.x, static_cast<float>(MIN_COORDINATE), static_cast<float>(MAX_COORDINATE))),
+				static_cast<int32_t>(std::clamp(scaled.y, static_cast<float>(MIN_COORDINATE), static_cast<float>(MAX_COORDINATE))),
+				static_cast<int32_t>(std::clamp(scaled.z, static_cast<float>(MIN_COORDINATE), static_cast<float>(MAX_COORDINATE))));
+		}
+
+		static inline uint64_t GetCellKey(const glm::ivec3& coordinates)
+		{
+			const uint64_t mask = (1ull << COORDINATE_BITS) - 1;
+			return (static_cast<uint64_t>(coordinates.x - MIN_COORDINATE) & mask) << (COORDINATE_BITS * 2)
+				| (static_cast<uint64_t>(coordinates.y - MIN_COORDINATE) & mask) << COORDINATE_BITS
+				| (static_cast<uint64_t>(coordinates.z - MIN_COORDINATE) & mask);
+		}
+
+		inline bool IsIndexed(Entity entity) const
+		{
+			const uint32_t index = entity.GetIndex();
+			if (index >= m_Locations.size() || m_Locations[index].cell == INVALID_CELL) return false;
+			const EntityLocation& location = m_Locations[index];
+			return m_Cells[location.cell].entries[location.slot].entity == entity;
+		}
+
+		uint32_t FindOrCreateCell(uint64_t key, const glm::ivec3& coordinates)
+		{
+			auto it = m_CellLookup.find(key);
+			if (it != m_CellLookup.end()) return it->second;
+
+			uint32_t cell;
+			if (!m_FreeCells.empty()) {
+				cell = m_FreeCells.back();
+				m_FreeCells.pop_back();
+			}
+			else {
+				cell = static_cast<uint32_t>(m_Cells.size());
+				m_Cells.emplace_back();
+			}
+			m_Cells[cell].key = key;
+			m_Cells[cell].coordinates = coordinates;
+			m_CellLookup.emplace(key, cell);
+			return cell;
+		}
+
+		// Swap and pop out of its cell, an emptied cell goes back to the free list
+		void RemoveFromCell(uint32_t entityIndex)
+		{
+			EntityLocation& location = m_Locations[entityIndex];
+			GridCell& cell = m_Cells[location.cell];
+
+			const GridEntry& last = cell.entries.back();
+			m_Locations[last.entity.GetIndex()].slot = location.slot;
+			cell.entries[location.slot] = last;
+			cell.entries.pop_back();
+			m_EntryCount--;
+
+			if (cell.entries.empty()) {
+				m_CellLookup.erase(cell.key);
+				m_FreeCells.push_back(location.cell);
+			}
+			location = EntityLocation();
+		}
+
+		// Puts the entity at 'position', wherever it was before
+		void Place(Entity entity, const glm::vec3& position)
+		{
+			const uint32_t index = entity.GetIndex();
+			if (index >= m_Locations.size()) m_Locations.resize(index + 1);
+
+			const glm::ivec3 coordinates = GetCellCoordinates(position);
+			const uint64_t key = GetCellKey(coordinates);
+
+			EntityLocation& location = m_Locations[index];
+			if (location.cell != INVALID_CELL) {
+				GridEntry& entry = m_Cells[location.cell].entries[location.slot];
+				// Most moves stay inside the cell
+				if (m_Cells[location.cell].key == key) {
+					entry.entity = entity;
+					entry.position = position;
+					return;
+				}
+				RemoveFromCell(index);
+			}
+
+			const uint32_t cell = FindOrCreateCell(key, coordinates);
+			location.cell = cell;
+			location.slot = static_cast<uint32_t>(m_Cells[cell].entries.size());
+			m_Cells[cell].entries.push_back({ entity, position });
+			m_EntryCount++;
+		}
+
+		// Calls f(cell) for every existing cell between the two corners (inclusive).
+		// A shape that covers more cells than exist walks the existing ones instead of looking up empty space
+		template <typename F>
+		void ForEachCellIn(const glm::ivec3& minCell, const glm::ivec3& maxCell, F&& f) const
+		{
+			const uint64_t rangeCells = static_cast<uint64_t>(maxCell.x - minCell.x + 1)
+				* static_cast<uint64_t>(maxCell.y - minCell.y + 1)
+				* static_cast<uint64_t>(maxCell.z - minCell.z + 1);
+
+			if (rangeCells <= m_CellLookup.size()) {
+				for (int32_t x = minCell.x; x <= maxCell.x; ++x) {
+					for (int32_t y = minCell.y; y <= maxCell.y; ++y) {
+						for (int32_t z = minCell.z; z <= maxCell.z; ++z) {
+							const auto it = m_CellLookup.find(GetCellKey({ x, y, z }));
+							if (it != m_CellLookup.end()) f(m_Cells[it->second]);
+						}
+					}
+				}
+				return;
+			}
+
+			for (const GridCell& cell : m_Cells) {
+				if (cell.entries.empty()) continue;
+				const glm::ivec3& c = cell.coordinates;
+				if (c.x >= minCell.x && c.x <= maxCell.x && c.y >= minCell.y && c.y <= maxCell.y && c.z >= minCell.z && c.z <= maxCell.z) {
+					f(cell);
+				}
+			}
+		}
+
+	public:
+		// 'cellSize' around the usual query radius: much smaller and a query visits lots of cells,
+		// much bigger and every cell holds a crowd that mostly fails the distance test
+		explicit SpatialGridSystem(float cellSize = 8.0f)
+			: m_CellSize(cellSize), m_InverseCellSize(1.0f / cellSize)
+		{
+			assert(cellSize > 0.0f && "The cell size must be positive!");
+			RequireComponent<WorldTransformComponent>(ComponentAccess::Read);
+		}
+
+		void OnEntityAdded(Entity entity) override
+		{
+			m_Added.push_back(entity);
+		}
+
+		void OnEntityRemoved(Entity entity) override
+		{
+			if (IsIndexed(entity)) RemoveFromCell(entity.GetIndex());
+		}
+
+		// Compact() renumbered the entities: the grid is keyed by entity index, start over with the new ones
+		void OnEntitiesRemapped(ECSOrchestrator& ecs, const EntityRemap& /*remap*/) override
+		{
+			Rebuild(ecs);
+		}
+
+		// Throws the grid away and puts every member back from its current world position
+		void Rebuild(ECSOrchestrator& ecs)
+		{
+			m_CellLookup.clear();
+			m_Cells.clear();
+			m_FreeCells.clear();
+			m_Locations.clear();
+			m_Added.clear();
+			m_EntryCount = 0;
+
+			for (const Entity& entity : GetSystemEntities()) {
+				Place(entity, ecs.GetComponent<WorldTransformComponent>(entity).GetPosition());
+			}
+		}
+
+		// Changes the cell size, everything is put back in the new cells
+		void SetCellSize(ECSOrchestrator& ecs, float cellSize)
+		{
+			assert(cellSize > 0.0f && "The cell size must be positive!");
+			m_CellSize = cellSize;
+			m_InverseCellSize = 1.0f / cellSize;
+			Rebuild(ecs);
+		}
+
+		void RunSystem(ECSOrchestrator& ecs)
+		{
+			const uint32_t since = m_LastRunTick;
+			m_LastRunTick = ecs.ClaimChangeTick();
+
+			// The ones that joined, unless they already left again
+			for (const Entity& entity : m_Added) {
+				if (ecs.IsAlive(entity) && HasEntity(entity)) {
+					Place(entity, ecs.GetComponent<WorldTransformComponent>(entity).GetPosition());
+				}
+			}
+			m_Added.clear();
+
+			// Everything the TransformSystem moved
+			for (auto [entity, world] : ecs.View<WorldTransformComponent>().Changed<WorldTransformComponent>(since)) {
+				if (IsIndexed(entity)) {
+					Place(entity, world.GetPosition());
+				}
+			}
+		}
+
+		// Calls f(entity, position) for every entity whose position is inside the box
+		template <typename F>
+		void ForEachInAABB(const AABB& box, F&& f) const
+		{
+			ForEachCellIn(GetCellCoordinates(box.min), GetCellCoordinates(box.max), [&](const GridCell& cell) {
+				for (const GridEntry& entry : cell.entries) {
+					const glm::vec3& p = entry.position;
+					if (p.x >= box.min.x && p.x <= box.max.x && p.y >= box.min.y && p.y <= box.max.y && p.z >= box.min.z && p.z <= box.max.z) {
+						f(entry.entity, p);
+					}
+				}
+				});
+		}
+
+		// Calls f(entity, position) for every entity whose position is inside the sphere
+		template <typename F>
+		void ForEachInSphere(const Sphere& sphere, F&& f) const
+		{
+			const glm::vec3 extent(sphere.radius);
+			const float radiusSquared = sphere.radius * sphere.radius;
+
+			ForEachCellIn(GetCellCoordinates(sphere.center - extent), GetCellCoordinates(sphere.center + extent), [&](const GridCell& cell) {
+				for (const GridEntry& entry : cell.entries) {
+					const glm::vec3 offset = entry.position - sphere.center;
+					if (glm::dot(offset, offset) <= radiusSquared) {
+						f(entry.entity, entry.position);
+					}
+				}
+				});
+		}
+
+		// Writes the entities inside the box into 'out' and returns how many there are.
+		// That can be more than out.size() (only the first out.size() are written), nothing is allocated
+		size_t QueryAABB(const AABB& box, std::span<Entity> out) const
+		{
+			size_t found = 0;
+			ForEachInAABB(box, [&](Entity entity, const glm::vec3&) {
+				if (found < out.size()) out[found] = entity;
+				found++;
+				});
+			return found;
+		}
+
+		// Same for a sphere, in no particular order
+		size_t QuerySphere(const Sphere& sphere, std::span<Entity> out) const
+		{
+			size_t found = 0;
+			ForEachInSphere(sphere, [&](Entity entity, const glm::vec3&) {
+				if (found < out.size()) out[found] = entity;
+				found++;
+				});
+			return found;
+		}
+
+		float GetCellSize() const { return m_CellSize; }
+		size_t GetIndexedCount() const { return m_EntryCount; }
+		size_t GetCellCount() const { return m_CellLookup.size(); }
+	};
+}
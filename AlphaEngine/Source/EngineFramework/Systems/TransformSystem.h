@@ -0,0 +1,297 @@
+#pragma once
+
+#include "EngineFramework/ECS/ECS.h"
+#include "EngineFramework/Components/TransformComponent.h"
+#include "EngineFramework/Components/WorldTransformComponent.h"
+#include "EngineFramework/Components/HierarchyComponent.h"
+#include "EngineFramework/Logger.h"
+#include "EngineFramework/TransformStreams.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace AlphaEngine
+{
+	// How the TransformSystem turns the changed roots (no HierarchyComponent) into world matrices
+	enum class TransformLayout : uint8_t
+	{
+		// One GetTransform() per entity, straight from the TransformComponent
+		AoS,
+		// Gathered into TransformStreams and composed by the SIMD kernel, 4 or 8 at a time (see TransformStreams.h)
+		SoA
+	};
+
+	// Turns the local TransformComponents into cached world matrices (WorldTransformComponent).
+	//
+	// Only what changed is recomputed: an entity whose Transform was marked changed since the last run
+	// is dirty, and so is everything below it. Every dirty subtree is walked breadth first from its top:
+	//
+	// Queue | [Car] [Platform] | [WheelFL] [WheelFR] [Crate] | [Bolt] ...
+	//         dirty tops          their children               their children
+	//
+	// so a parent is always done before its children read its matrix, and the queue is one flat array
+	// we keep between frames (no recursion, no allocation).
+	// A dirty entity below another dirty entity is skipped as a top, its ancestor's walk reaches it anyway.
+	//
+	// Roots are most of a world (every ball, every prop) and have nobody to wait for, so with TransformLayout::SoA
+	// they skip the queue: their Transforms go into TransformStreams while we look for dirty entities,
+	// and one ComposeTransforms call builds all their matrices. Physics writes the TransformComponents,
+	// the renderer reads the WorldTransformComponents, neither cares which layout made them.
+	//
+	// Add it before creating entities, it hooks TransformComponent so every entity with one gets a WorldTransformComponent.
+	class TransformSystem : public System
+	{
+	private:
+		TransformLayout m_Layout;
+
+		// Scratch, kept between frames
+		std::vector<Entity> m_Dirty;
+		std::vector<Entity> m_Queue;
+
+		// SoA only: the transforms of the changed roots and where their world matrices go [same index in both]
+		TransformStreams m_BatchStreams;
+		std::vector<glm::mat4*> m_BatchTargets;
+
+		// Run number in which the entity was found dirty [vector index = entity index],
+		// comparing with m_RunIndex means we never have to clear it
+		std::vector<uint32_t> m_DirtyRun;
+		uint32_t m_RunIndex = 0;
+
+		inline bool IsDirty(Entity entity) const
+		{
+			const uint32_t index = entity.GetIndex();
+			return index < m_DirtyRun.size() && m_DirtyRun[index] == m_RunIndex;
+		}
+
+		bool HasDirtyAncestor(const ECSOrchestrator& ecs, Entity entity) const
+		{
+			if (!ecs.HasComponent<HierarchyComponent>(entity)) return false;
+
+			for (Entity ancestor = ecs.GetComponent<HierarchyComponent>(entity).parent; ancestor.IsValid();
+				ancestor = ecs.GetComponent<HierarchyComponent>(ancestor).parent) {
+				// The walk below stops at a node without a Transform, nothing above it reaches us
+				if (!ecs.HasComponent<WorldTransformComponent>(ancestor)) return false;
+				if (IsDirty(ancestor)) return true;
+			}
+			return false;
+		}
+
+		// Takes the entity out of its parent's children list, the entity becomes a root
+		static void Unlink(ECSOrchestrator& ecs, Entity entity)
+		{
+			auto& hierarchy = ecs.GetComponent<HierarchyComponent>(entity);
+			if (!hierarchy.parent.IsValid()) return;
+
+			auto& parentHierarchy = ecs.GetComponent<HierarchyComponent>(hierarchy.parent);
+			if (hierarchy.prevSibling.IsValid()) {
+				ecs.GetComponent<HierarchyComponent>(hierarchy.prevSibling).nextSibling = hierarchy.nextSibling;
+			}
+			else {
+				parentHierarchy.firstChild = hierarchy.nextSibling;
+			}
+			if (hierarchy.nextSibling.IsValid()) {
+				ecs.GetComponent<HierarchyComponent>(hierarchy.nextSibling).prevSibling = hierarchy.prevSibling;
+			}
+			parentHierarchy.childCount--;
+
+			hierarchy.parent = Entity();
+			hierarchy.prevSibling = Entity();
+			hierarchy.nextSibling = Entity();
+		}
+
+		// Its world matrix means something else now, recompute it (and its subtree) on the next run
+		static void MarkHierarchyChanged(ECSOrchestrator& ecs, Entity entity)
+		{
+			if (ecs.HasComponent<TransformComponent>(entity)) {
+				ecs.MarkChanged<TransformComponent>(entity);
+			}
+		}
+
+	public:
+		TransformSystem(ECSOrchestrator& ecs, TransformLayout layout = TransformLayout::SoA)
+			: m_Layout(layout)
+		{
+			RequireComponent<TransformComponent>(ComponentAccess::Read);
+			RequireComponent<WorldTransformComponent>(ComponentAccess::ReadWrite);
+			DeclareAccess<HierarchyComponent>(ComponentAccess::Read);
+
+			// The hooks don't capture the system, they only need the orchestrator they are called with
+
+			// Every Transform gets its cached world matrix, already right for a root
+			ecs.OnConstruct<TransformComponent>([](ECSOrchestrator& ecs, Entity entity) {
+				WorldTransformComponent world;
+				world.matrix = ecs.GetComponent<TransformComponent>(entity).GetTransform();
+				ecs.AddComponent<WorldTransformComponent>(entity, world);
+				});
+			ecs.OnDestroy<TransformComponent>([](ECSOrchestrator& ecs, Entity entity) {
+				ecs.RemoveComponent<WorldTransformComponent>(entity);
+				});
+
+			// Removing the hierarchy (or destroying the entity) leaves its children as roots.
+			// Use DestroyWithChildren to take the whole subtree down
+			ecs.OnDestroy<HierarchyComponent>([](ECSOrchestrator& ecs, Entity entity) {
+				auto& hierarchy = ecs.GetComponent<HierarchyComponent>(entity);
+				if (hierarchy.parent.IsValid()) {
+					Unlink(ecs, entity);
+					MarkHierarchyChanged(ecs, entity);
+				}
+
+				Entity child = hierarchy.firstChild;
+				while (child.IsValid()) {
+					auto& childHierarchy = ecs.GetComponent<HierarchyComponent>(child);
+					const Entity next = childHierarchy.nextSibling;
+					childHierarchy.parent = Entity();
+					childHierarchy.prevSibling = Entity();
+					childHierarchy.nextSibling = Entity();
+					MarkHierarchyChanged(ecs, child);
+					child = next;
+				}
+				hierarchy.firstChild = Entity();
+				hierarchy.childCount = 0;
+				});
+		}
+
+		// Compact() renumbered the entities: the hierarchy links follow them
+		void OnEntitiesRemapped(ECSOrchestrator& ecs, const EntityRemap& remap) override
+		{
+			for (auto [entity, hierarchy] : ecs.View<HierarchyComponent>()) {
+				hierarchy.parent = remap(hierarchy.parent);
+				hierarchy.firstChild = remap(hierarchy.firstChild);
+				hierarchy.prevSibling = remap(hierarchy.prevSibling);
+				hierarchy.nextSibling = remap(hierarchy.nextSibling);
+			}
+
+			// Indexed by the old entity indices, and sized for the peak
+			m_DirtyRun.clear();
+			m_DirtyRun.shrink_to_fit();
+		}
+
+		// Attaches 'child' under 'parent' (a Null parent detaches it). Main thread only, it can add HierarchyComponents.
+		// The child's TransformComponent is kept as is, so from now on it is read relative to the parent.
+		// A parent without a TransformComponent (a pure grouping node) counts as the origin for its children
+		static void SetParent(ECSOrchestrator& ecs, Entity child, Entity parent)
+		{
+			assert(ecs.IsAlive(child) && "SetParent on a dead entity!");
+			assert(child != parent && "An entity can't be its own parent!");
+
+			// Add both first, adding can move the pool and would invalidate the references below
+			if (!ecs.HasComponent<HierarchyComponent>(child)) ecs.AddComponent<HierarchyComponent>(child);
+			if (parent.IsValid()) {
+				assert(ecs.IsAlive(parent) && "SetParent to a dead entity!");
+				if (!ecs.HasComponent<HierarchyComponent>(parent)) ecs.AddComponent<HierarchyComponent>(parent);
+
+				for (Entity ancestor = parent; ancestor.IsValid(); ancestor = ecs.GetComponent<HierarchyComponent>(ancestor).parent) {
+					if (ancestor == child) {
+						Logger::Err("[TransformSystem]: SetParent would make a cycle, ignored");
+						return;
+					}
+				}
+			}
+
+			if (ecs.GetComponent<HierarchyComponent>(child).parent == parent) return;
+
+			Unlink(ecs, child);
+
+			if (parent.IsValid()) {
+				auto& hierarchy = ecs.GetComponent<HierarchyComponent>(child);
+				auto& parentHierarchy = ecs.GetComponent<HierarchyComponent>(parent);
+
+				hierarchy.parent = parent;
+				hierarchy.nextSibling = parentHierarchy.firstChild;
+				if (parentHierarchy.firstChild.IsValid()) {
+					ecs.GetComponent<HierarchyComponent>(parentHierarchy.firstChild).prevSibling = child;
+				}
+				parentHierarchy.firstChild = child;
+				parentHierarchy.childCount++;
+			}
+
+			MarkHierarchyChanged(ecs, child);
+		}
+
+		static void Detach(ECSOrchestrator& ecs, Entity child) { SetParent(ecs, child, Entity()); }
+
+		// Destroys the entity and everything below it
+		static void DestroyWithChildren(ECSOrchestrator& ecs, Entity entity)
+		{
+			if (ecs.HasComponent<HierarchyComponent>(entity)) {
+				for (Entity child = ecs.GetComponent<HierarchyComponent>(entity).firstChild; child.IsValid();
+					child = ecs.GetComponent<HierarchyComponent>(child).nextSibling) {
+					DestroyWithChildren(ecs, child);
+				}
+			}
+			ecs.DestroyEntity(entity);
+		}
+
+		void RunSystem(ECSOrchestrator& ecs)
+		{
+			const uint32_t since = m_LastRunTick;
+			m_LastRunTick = ecs.ClaimChangeTick();
+			m_RunIndex++;
+
+			// Everything moved, reparented or just created since the last run
+			m_Dirty.clear();
+			const auto changed = ecs.View<TransformComponent, WorldTransformComponent>().Changed<TransformComponent>(since);
+			const bool batchRoots = m_Layout == TransformLayout::SoA;
+			size_t batchCount = 0;
+			if (batchRoots) {
+				// Room for the worst case, cut down to what we found after the loop
+				m_BatchStreams.Resize(changed.SizeHint());
+				m_BatchTargets.resize(changed.SizeHint());
+			}
+
+			for (auto [entity, transform, world] : changed) {
+				// Without a HierarchyComponent it has no parent and no children (SetParent gives both sides one),
+				// nothing else in this run depends on it.
+				// Nothing gets added or removed until the kernel ran, so the pointer to its matrix stays good
+				if (batchRoots && !ecs.HasComponent<HierarchyComponent>(entity)) {
+					m_BatchStreams.Set(batchCount, transform.position, transform.rotation, transform.scale);
+					m_BatchTargets[batchCount++] = &world.matrix;
+					ecs.MarkChanged<WorldTransformComponent>(entity);
+					continue;
+				}
+
+				const uint32_t index = entity.GetIndex();
+				if (index >= m_DirtyRun.size()) m_DirtyRun.resize(index + 1, 0);
+				m_DirtyRun[index] = m_RunIndex;
+				m_Dirty.push_back(entity);
+			}
+
+			if (batchCount > 0) {
+				m_BatchStreams.Resize(batchCount);
+				ComposeTransforms(m_BatchStreams, m_BatchTargets.data());
+			}
+			if (m_Dirty.empty()) return;
+
+			// The tops of the dirty subtrees
+			m_Queue.clear();
+			for (const Entity& entity : m_Dirty) {
+				if (!HasDirtyAncestor(ecs, entity)) {
+					m_Queue.push_back(entity);
+				}
+			}
+
+			// Breadth first, the queue grows with the children while we walk it
+			for (size_t i = 0; i < m_Queue.size(); ++i) {
+				const Entity entity = m_Queue[i];
+				const glm::mat4 local = ecs.GetComponent<TransformComponent>(entity).GetTransform();
+				glm::mat4& world = ecs.PatchComponent<WorldTransformComponent>(entity).matrix;
+
+				if (!ecs.HasComponent<HierarchyComponent>(entity)) {
+					world = local;
+					continue;
+				}
+
+				// A parent without a Transform (a grouping node, or one that lost it) counts as the origin
+				const auto& hierarchy = ecs.GetComponent<HierarchyComponent>(entity);
+				const bool hasParentWorld = hierarchy.parent.IsValid() && ecs.HasComponent<WorldTransformComponent>(hierarchy.parent);
+				world = hasParentWorld ? ecs.GetComponent<WorldTransformComponent>(hierarchy.parent).matrix * local : local;
+
+				for (Entity child = hierarchy.firstChild; child.IsValid(); child = ecs.GetComponent<HierarchyComponent>(child).nextSibling) {
+					// A child without a Transform just passes nothing down
+					if (ecs.HasComponent<TransformComponent>(child)) {
+						m_Queue.push_back(child);
+					}
+				}
+			}
+		}
+	};
+}
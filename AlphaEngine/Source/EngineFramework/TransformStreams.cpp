@@ -0,0 +1,213 @@
+#include "EngineFramework/TransformStreams.h"
+#include <initializer_list>
+
+// Same selection as SignatureMatch.h, one instruction set per build
+#if defined(__AVX2__)
+#define ALPHA_TRANSFORM_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ALPHA_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AlphaEngine
+{
+	void TransformStreams::Clear()
+	{
+		for (std::vector<float>* stream : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ }) {
+			stream->clear();
+		}
+	}
+
+	void TransformStreams::Reserve(size_t count)
+	{
+		for (std::vector<float>* stream : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ }) {
+			stream->reserve(count);
+		}
+	}
+
+	void TransformStreams::Resize(size_t count)
+	{
+		for (std::vector<float>* stream : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ }) {
+			stream->resize(count);
+		}
+	}
+
+	void TransformStreams::Push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		positionX.push_back(position.x);
+		positionY.push_back(position.y);
+		positionZ.push_back(position.z);
+		rotationX.push_back(rotation.x);
+		rotationY.push_back(rotation.y);
+		rotationZ.push_back(rotation.z);
+		rotationW.push_back(rotation.w);
+		scaleX.push_back(scale.x);
+		scaleY.push_back(scale.y);
+		scaleZ.push_back(scale.z);
+	}
+
+	// The rotation matrix of a unit quaternion (what glm::toMat4 builds), every axis times its scale:
+	//
+	// column 0 = (1 - 2(yy + zz),  2(xy + wz),      2(xz - wy))     * scale.x
+	// column 1 = (2(xy - wz),      1 - 2(xx + zz),  2(yz + wx))     * scale.y
+	// column 2 = (2(xz + wy),      2(yz - wx),      1 - 2(xx + yy)) * scale.z
+	// column 3 = (position, 1)
+	static inline void ComposeOne(const TransformStreams& streams, size_t i, glm::mat4& out)
+	{
+		const float x = streams.rotationX[i], y = streams.rotationY[i], z = streams.rotationZ[i], w = streams.rotationW[i];
+		const float xx = x * x, yy = y * y, zz = z * z;
+		const float xy = x * y, xz = x * z, yz = y * z;
+		const float wx = w * x, wy = w * y, wz = w * z;
+		const float sx = streams.scaleX[i], sy = streams.scaleY[i], sz = streams.scaleZ[i];
+
+		out[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f);
+		out[1] = glm::vec4(2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f);
+		out[2] = glm::vec4(2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f);
+		out[3] = glm::vec4(streams.positionX[i], streams.positionY[i], streams.positionZ[i], 1.0f);
+	}
+
+#if defined(ALPHA_TRANSFORM_AVX2)
+
+	// The 4 rows (x, y, z, w of one column for 8 transforms) -> that column of each of the 8 matrices.
+	// 'target(k)' is the matrix of transform i + k, wherever it lives
+	template <typename Target>
+	static inline void StoreColumn(__m256 x, __m256 y, __m256 z, __m256 w, Target& target, int column)
+	{
+		const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+		const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+		const __m256 zw0 = _mm256_unpacklo_ps(z, w);
+		const __m256 zw1 = _mm256_unpackhi_ps(z, w);
+
+		// Each 128 bit half holds one matrix column: low half -> transform k, high half -> transform k + 4
+		const __m256 columns[4] = {
+			_mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2)),
+			_mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2)),
+		};
+		for (int k = 0; k < 4; ++k) {
+			_mm_storeu_ps(&target(k)[column][0], _mm256_castps256_ps128(columns[k]));
+			_mm_storeu_ps(&target(k + 4)[column][0], _mm256_extractf128_ps(columns[k], 1));
+		}
+	}
+
+	template <typename Target>
+	static inline void ComposeBlock(const TransformStreams& streams, size_t i, Target& target)
+	{
+		const __m256 x = _mm256_loadu_ps(&streams.rotationX[i]);
+		const __m256 y = _mm256_loadu_ps(&streams.rotationY[i]);
+		const __m256 z = _mm256_loadu_ps(&streams.rotationZ[i]);
+		const __m256 w = _mm256_loadu_ps(&streams.rotationW[i]);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 zero = _mm256_setzero_ps();
+
+		const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+		const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+		const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+		const __m256 sx = _mm256_loadu_ps(&streams.scaleX[i]);
+		const __m256 sy = _mm256_loadu_ps(&streams.scaleY[i]);
+		const __m256 sz = _mm256_loadu_ps(&streams.scaleZ[i]);
+
+		auto diagonal = [&](__m256 a, __m256 b, __m256 scale) { return _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(a, b))), scale); };
+		auto sum = [&](__m256 a, __m256 b, __m256 scale) { return _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(a, b)), scale); };
+		auto difference = [&](__m256 a, __m256 b, __m256 scale) { return _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(a, b)), scale); };
+
+		StoreColumn(diagonal(yy, zz, sx), sum(xy, wz, sx), difference(xz, wy, sx), zero, target, 0);
+		StoreColumn(difference(xy, wz, sy), diagonal(xx, zz, sy), sum(yz, wx, sy), zero, target, 1);
+		StoreColumn(sum(xz, wy, sz), difference(yz, wx, sz), diagonal(xx, yy, sz), zero, target, 2);
+		StoreColumn(_mm256_loadu_ps(&streams.positionX[i]), _mm256_loadu_ps(&streams.positionY[i]), _mm256_loadu_ps(&streams.positionZ[i]), one, target, 3);
+	}
+
+	static constexpr size_t BlockSize = 8;
+
+#elif defined(ALPHA_TRANSFORM_SSE2)
+
+	// The 4 rows (x, y, z, w of one column for 4 transforms) -> that column of each of the 4 matrices.
+	// 'target(k)' is the matrix of transform i + k, wherever it lives
+	template <typename Target>
+	static inline void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, Target& target, int column)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&target(0)[column][0], x);
+		_mm_storeu_ps(&target(1)[column][0], y);
+		_mm_storeu_ps(&target(2)[column][0], z);
+		_mm_storeu_ps(&target(3)[column][0], w);
+	}
+
+	template <typename Target>
+	static inline void ComposeBlock(const TransformStreams& streams, size_t i, Target& target)
+	{
+		const __m128 x = _mm_loadu_ps(&streams.rotationX[i]);
+		const __m128 y = _mm_loadu_ps(&streams.rotationY[i]);
+		const __m128 z = _mm_loadu_ps(&streams.rotationZ[i]);
+		const __m128 w = _mm_loadu_ps(&streams.rotationW[i]);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+		const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+		const __m128 sx = _mm_loadu_ps(&streams.scaleX[i]);
+		const __m128 sy = _mm_loadu_ps(&streams.scaleY[i]);
+		const __m128 sz = _mm_loadu_ps(&streams.scaleZ[i]);
+
+		auto diagonal = [&](__m128 a, __m128 b, __m128 scale) { return _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(a, b))), scale); };
+		auto sum = [&](__m128 a, __m128 b, __m128 scale) { return _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(a, b)), scale); };
+		auto difference = [&](__m128 a, __m128 b, __m128 scale) { return _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(a, b)), scale); };
+
+		StoreColumn(diagonal(yy, zz, sx), sum(xy, wz, sx), difference(xz, wy, sx), zero, target, 0);
+		StoreColumn(difference(xy, wz, sy), diagonal(xx, zz, sy), sum(yz, wx, sy), zero, target, 1);
+		StoreColumn(sum(xz, wy, sz), difference(yz, wx, sz), diagonal(xx, yy, sz), zero, target, 2);
+		StoreColumn(_mm_loadu_ps(&streams.positionX[i]), _mm_loadu_ps(&streams.positionY[i]), _mm_loadu_ps(&streams.positionZ[i]), one, target, 3);
+	}
+
+	static constexpr size_t BlockSize = 4;
+
+#endif
+
+	// 'matrixAt(i)' -> where the matrix of entry i goes
+	template <typename MatrixAt>
+	static inline void Compose(const TransformStreams& streams, MatrixAt&& matrixAt)
+	{
+		const size_t count = streams.Size();
+		size_t i = 0;
+
+#if defined(ALPHA_TRANSFORM_AVX2) || defined(ALPHA_TRANSFORM_SSE2)
+		for (; i + BlockSize <= count; i += BlockSize) {
+			auto target = [&, i](size_t k) -> glm::mat4& { return matrixAt(i + k); };
+			ComposeBlock(streams, i, target);
+		}
+#endif
+
+		// What doesn't fill a block
+		for (; i < count; ++i) {
+			ComposeOne(streams, i, matrixAt(i));
+		}
+	}
+
+	void ComposeTransforms(const TransformStreams& streams, glm::mat4* out)
+	{
+		Compose(streams, [out](size_t i) -> glm::mat4& { return out[i]; });
+	}
+
+	void ComposeTransforms(const TransformStreams& streams, glm::mat4* const* targets)
+	{
+		Compose(streams, [targets](size_t i) -> glm::mat4& { return *targets[i]; });
+	}
+
+	const char* GetTransformKernelName()
+	{
+#if defined(ALPHA_TRANSFORM_AVX2)
+		return "avx2";
+#elif defined(ALPHA_TRANSFORM_SSE2)
+		return "sse2";
+#else
+		return "scalar";
+#endif
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstddef>
+
+namespace AlphaEngine
+{
+	// Structure of arrays copy of a batch of TransformComponents: every float of
+	// position/rotation/scale is its own stream, so the kernel loads the same field of 4 (SSE)
+	// or 8 (AVX2) transforms with one instruction.
+	//
+	// AoS (TransformComponent) | px py pz qx qy qz qw sx sy sz | px py pz ... |
+	// SoA (TransformStreams)   positionX | px px px px px ... |
+	//                          positionY | py py py py py ... |  ...
+	//
+	// The TransformSystem fills one with the root transforms that changed and turns them into world matrices in one go
+	struct TransformStreams
+	{
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+		std::vector<float> scaleX, scaleY, scaleZ;
+
+		inline size_t Size() const { return positionX.size(); }
+
+		void Clear();
+		void Reserve(size_t count);
+		void Resize(size_t count);
+		void Push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+		// Overwrites entry i, for filling a Resize()d batch without the 10 capacity checks of Push
+		inline void Set(size_t i, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+		{
+			positionX[i] = position.x;
+			positionY[i] = position.y;
+			positionZ[i] = position.z;
+			rotationX[i] = rotation.x;
+			rotationY[i] = rotation.y;
+			rotationZ[i] = rotation.z;
+			rotationW[i] = rotation.w;
+			scaleX[i] = scale.x;
+			scaleY[i] = scale.y;
+			scaleZ[i] = scale.z;
+		}
+	};
+
+	// out[i] = Translation * Rotation * Scale of entry i, the same matrix as TransformComponent::GetTransform().
+	// 'out' must hold streams.Size() matrices.
+	// Built straight from the quaternion (no matrix multiplies), 8 transforms at a time with AVX2 (the engine
+	// built with ALPHA_ENABLE_AVX2), 4 with SSE2 (any other x64 build), one by one elsewhere
+	void ComposeTransforms(const TransformStreams& streams, glm::mat4* out);
+
+	// Same, but entry i goes to *targets[i]: straight into the components, without a matrix array in between
+	void ComposeTransforms(const TransformStreams& streams, glm::mat4* const* targets);
+
+	// "avx2", "sse2" or "scalar", for the bench report
+	const char* GetTransformKernelName();
+}
@@ -12,6 +12,8 @@
 #include "EngineFramework/Systems/PlayerControllerSystem.h"
 #include "EngineFramework/Systems/MovementSystem.h"
 #include "EngineFramework/Systems/PhysicsSystem.h"
+#include "EngineFramework/Systems/TransformSystem.h"
+#include "EngineFramework/Systems/SpatialGridSystem.h"
 #include "EngineFramework/Utility.h"
 #include <iostream>
 #include <print>
@@ -51,13 +53,25 @@ namespace AlphaEngine
 
 
 
-		ecsOrchestrator.AddSystem<RenderSystem>();
+		// First, it hooks the TransformComponent so every entity created below gets its world matrix
+		ecsOrchestrator.AddSystem<TransformSystem>(ecsOrchestrator);
+		// Proximity queries for gameplay, kept up to date from the world transforms
+		ecsOrchestrator.AddSystem<SpatialGridSystem>();
+		m_RenderSystem = &ecsOrchestrator.AddSystem<RenderSystem>();
 		ecsOrchestrator.AddSystem<CameraSystem>();
 		ecsOrchestrator.AddSystem<PlayerControllerSystem>();
 		ecsOrchestrator.AddSystem<MovementSystem>();
-		ecsOrchestrator.AddSystem<PhysicsSystem>();
-
+		m_PhysicsSystem = &ecsOrchestrator.AddSystem<PhysicsSystem>();
 
+		// Compact() renumbers the entities, the handles this layer keeps have to follow them
+		ecsOrchestrator.OnCompact([this](ECSOrchestrator&, const EntityRemap& remap) {
+			for (Entity* entity : { &monkeyA, &monkeyB, &sphereA, &sphereB, &sphereC, &sphereD, &floor, &MiniGolfModel, &goalZone }) {
+				*entity = remap(*entity);
+			}
+			for (Entity& entity : monkeyEntities) {
+				entity = remap(entity);
+			}
+			});
 
 		std::cout << "[AppLayer] Attaching:\n";
 
@@ -117,23 +131,30 @@ namespace AlphaEngine
 		float spacing = 0.5f;
 		int count = 20;
 
-		for (int i = 0; i < count; ++i) {
-			Entity ball = ecsOrchestrator.CreateEntity();
+		// Every ball is the same prefab, only where it spawns differs.
+		// Instantiate clones it in one batch: every pool grows once, one pass over the systems
+		Prefab ballPrefab;
+		ballPrefab.Add<TransformComponent>(glm::vec3(0.0f), glm::vec3(sphereRadius))
+			.Add<RenderComponent>(sphereModelHandle, basicShaderHandle, basicTextureHandle)
+			.Add<RigidBodyComponent>();
+
+		std::vector<TransformComponent> ballTransforms;
+		ballTransforms.reserve(count);
 
+		for (int i = 0; i < count; ++i) {
 			
 			float offsetX = (i % 5) * 0.1f;
 			float offsetZ = (i / 10) * 0.1f;
 			glm::vec3 pos(offsetX, 5.0f + (i * 1.5f), -3.0f + offsetZ);
 
-			
-			JPH::BodyID bodyID = ecsOrchestrator.GetSystem<PhysicsSystem>().CreateSphereBody(ball, pos, sphereRadius, false);
-
-			
-			ecsOrchestrator.AddComponent<TransformComponent>(ball, TransformComponent(pos, glm::vec3(sphereRadius)));
-			ecsOrchestrator.AddComponent<RenderComponent>(ball,
-				RenderComponent(sphereModelHandle, basicShaderHandle, basicTextureHandle));
-			ecsOrchestrator.AddComponent<RigidBodyComponent>(ball, RigidBodyComponent{ bodyID });
+			ballTransforms.emplace_back(pos, glm::vec3(sphereRadius));
 		}
+
+		std::vector<Entity> balls = ecsOrchestrator.Instantiate(ballPrefab, count, std::span(ballTransforms));
+
+		// Their bodies in one batch too, sharing one sphere shape
+		auto& physicsSystem = *m_PhysicsSystem;
+		physicsSystem.CreateBodies(ecsOrchestrator, balls, physicsSystem.MakeSphereSettings(sphereRadius, false));
 		
 
 		// Creating Entities just for testing
@@ -164,7 +185,7 @@ namespace AlphaEngine
 		glm::vec3 golfModelPos(0.f, -6.f, -1.f);
 		glm::vec3 golfModelScale(5.0f, 5.0f, 5.0f);
 
-		ecsOrchestrator.GetSystem<PhysicsSystem>().RequestMeshBody(
+		m_PhysicsSystem->RequestMeshBody(
 			MiniGolfModel,
 			golfModelHandle,
 			golfModelPos,
@@ -199,7 +220,7 @@ namespace AlphaEngine
 
 		// Spheres
 
-		JPH::BodyID sphereBodyIDA = ecsOrchestrator.GetSystem<PhysicsSystem>().CreateSphereBody(sphereA, spherePosA, sphereRadius, false);
+		JPH::BodyID sphereBodyIDA = m_PhysicsSystem->CreateSphereBody(sphereA, spherePosA, sphereRadius, false);
 		//JPH::BodyID floorBodyID = ecsOrchestrator.GetSystem<PhysicsSystem>().CreateBoxBody(floor,floorPos, floorHalfExtents, true);
 		//JPH::BodyID sphereBodyIDB = ecsOrchestrator.GetSystem<PhysicsSystem>().CreateSphereBody(sphereB, spherePosB, sphereRadius, false);
 		//JPH::BodyID sphereBodyIDC = ecsOrchestrator.GetSystem<PhysicsSystem>().CreateSphereBody(sphereC, spherePosC, sphereRadius, false);
@@ -386,6 +407,9 @@ namespace AlphaEngine
 			std::cout << "[Performance] FPS: " << fps
 				<< " | Avg Delta: " << avgDeltaTime << "ms" << std::endl;
 
+			// How much of the update actually ran in parallel (last frame)
+			ecsOrchestrator.GetScheduler().LogLastFrame();
+
 			// Reset for the next second
 			m_FPSAccumulator = 0.0f;
 			m_FrameCounter = 0;
@@ -394,10 +418,19 @@ namespace AlphaEngine
 		
 		auto& input = ServiceLocator::Get<Input>();
 
-		ecsOrchestrator.GetSystem<CameraSystem>().RunSystem(ecsOrchestrator);
-		ecsOrchestrator.GetSystem<PlayerControllerSystem>().RunSystem(ecsOrchestrator, input);
-		//ecsOrchestrator.GetSystem<MovementSystem>().RunSystem(ecsOrchestrator, deltaTime);
-		ecsOrchestrator.GetSystem<PhysicsSystem>().RunSystem(ecsOrchestrator, deltaTime);
+		// Fixed rate / time sliced / manual systems find out here if they run this frame
+		ecsOrchestrator.BeginFrame(deltaTime);
+
+		// The scheduler only overlaps the ones whose components don't conflict, the rest run in this order:
+		// whatever moves Transforms -> TransformSystem (world matrices) -> SpatialGrid and Camera (read the world positions)
+		// (PlayerController runs next to Physics, they don't share anything)
+		ecsOrchestrator.ScheduleSystem<PlayerControllerSystem>([&](PlayerControllerSystem& system) { system.RunSystem(ecsOrchestrator, input); });
+		//ecsOrchestrator.ScheduleSystem<MovementSystem>([&](MovementSystem& system) { system.RunSystem(ecsOrchestrator, deltaTime); });
+		ecsOrchestrator.ScheduleSystem<PhysicsSystem>([&](PhysicsSystem& system) { system.RunSystem(ecsOrchestrator, deltaTime); });
+		ecsOrchestrator.ScheduleSystem<TransformSystem>([&](TransformSystem& system) { system.RunSystem(ecsOrchestrator); });
+		ecsOrchestrator.ScheduleSystem<SpatialGridSystem>([&](SpatialGridSystem& system) { system.RunSystem(ecsOrchestrator); });
+		ecsOrchestrator.ScheduleSystem<CameraSystem>([&](CameraSystem& system) { system.RunSystem(ecsOrchestrator); });
+		ecsOrchestrator.RunScheduledSystems();
 
 	}
 
@@ -407,7 +440,7 @@ namespace AlphaEngine
 		auto& ecsOrchestrator = ServiceLocator::Get<ECSOrchestrator>();
 		auto& currentRenderer = ServiceLocator::Get<IRenderer>();
 
-		ecsOrchestrator.GetSystem<RenderSystem>().RunSystem(currentRenderer, ecsOrchestrator);
+		m_RenderSystem->RunSystem(currentRenderer, ecsOrchestrator);
 
 	}
 
@@ -432,7 +465,7 @@ namespace AlphaEngine
 	{
 		auto& ecsOrchestrator = ServiceLocator::Get<ECSOrchestrator>();
 
-		auto& physicsSystem = ecsOrchestrator.GetSystem<PhysicsSystem>();
+		auto& physicsSystem = *m_PhysicsSystem;
 		auto& rb = ecsOrchestrator.GetComponent<RigidBodyComponent>(entity);
 		JPH::BodyInterface& bodyInterface = physicsSystem.jolt_PhysicsSystem->GetBodyInterface();
 
@@ -480,11 +513,11 @@ namespace AlphaEngine
 		auto& ecsOrchestrator = ServiceLocator::Get<ECSOrchestrator>();
 
 		auto& camera = ecsOrchestrator.GetComponent<CameraComponent>(ecsOrchestrator.GetPrimaryCamera());
-		auto& transform = ecsOrchestrator.GetComponent<TransformComponent>(ecsOrchestrator.GetPrimaryCamera());
-		auto& physicsSystem = ecsOrchestrator.GetSystem<PhysicsSystem>();
+		auto& worldTransform = ecsOrchestrator.GetComponent<WorldTransformComponent>(ecsOrchestrator.GetPrimaryCamera());
+		auto& physicsSystem = *m_PhysicsSystem;
 
 		// Creating our Ray from getting the mouse position from screen (+window height + width) to world 
-		Ray ray = AlphaEngine::CameraUtils::ScreenToWorldRay(m_MousePosition.x, m_MousePosition.y, m_WindowWidth, m_WindowHeight, camera, transform.position);
+		Ray ray = AlphaEngine::CameraUtils::ScreenToWorldRay(m_MousePosition.x, m_MousePosition.y, m_WindowWidth, m_WindowHeight, camera, worldTransform.GetPosition());
 
 		// We cast that ray and get a body id If valid we see what we received 
 		// We also check filters and such stuff
@@ -506,7 +539,7 @@ namespace AlphaEngine
 				bodyInterface.AddImpulse(hitID, impulse);
 
 				// Get the Entity ID back from Jolt (The Link)
-				Entity hitEntity = static_cast<Entity>(bodyInterface.GetUserData(hitID));
+				Entity hitEntity(static_cast<uint32_t>(bodyInterface.GetUserData(hitID)));
 				std::cout << "Kicked Entity: " << hitEntity.GetId() << " (Jolt ID: " << hitID.GetIndex() << ")" << std::endl;
 			}
 		}
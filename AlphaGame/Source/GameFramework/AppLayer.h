@@ -49,6 +49,10 @@ namespace AlphaEngine
 		void HandleMouseClick();
 
 
+		// Owned by the orchestrator, cached in OnAttach so the frame and the events don't look them up every time
+		class RenderSystem* m_RenderSystem = nullptr;
+		class PhysicsSystem* m_PhysicsSystem = nullptr;
+
 		// Just testing vars
 		std::unique_ptr<class Shader> m_BasicShader;
 		std::shared_ptr<class Mesh> m_CubeMesh;